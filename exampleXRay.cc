@@ -30,8 +30,19 @@
 #include "XRayDetectorConstruction.hh"
 #include "XRayActionInitialization.hh"
 #include "XRayPhysicsList.hh"
+#include "XRayForkRunner.hh"
+#include "XRayShard.hh"
+#include "XRaySweep.hh"
+#include "XRayResponseMatrix.hh"
+#include "XRayResourceUsage.hh"
 
 #include "G4RunManagerFactory.hh"
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#include "XRayTopology.hh"
+#include "XRayWorkerInitialization.hh"
+#include "G4Threading.hh"
+#endif
 
 #include "G4UImanager.hh"
 #include "G4UIcommand.hh"
@@ -42,14 +53,41 @@
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 
+#include <vector>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 namespace {
   void PrintUsage() {
     G4cerr << " Usage: " << G4endl;
-    G4cerr << " exampleXRay [-m macro ] [-u UIsession] [-t nThreads]" << G4endl;
-    G4cerr << "   note: -t option is available only for multi-threaded mode."
+    G4cerr << " exampleXRay [-m macro ] [-u UIsession] [-t nThreads]"
+           << " [-s sd|step] [-p full|lite]" << G4endl;
+    G4cerr << "             [-r default|serial|mt|tasking|tbb]"
+           << " [-g eventModulo] [-b seedOnce]" << G4endl;
+    G4cerr << "             [--pin compact|scatter] [--shard i/N]" << G4endl;
+    G4cerr << "   note: -t, -g, -b and --pin options are available only for"
+           << " multi-threaded mode." << G4endl;
+    G4cerr << "   -t auto starts one thread per physical core." << G4endl;
+    G4cerr << "   --pin pins each worker thread to a core, filling the NUMA"
+           << " nodes one by one (compact)" << G4endl;
+    G4cerr << "      or in turn (scatter), before the hyperthreads."
            << G4endl;
+    G4cerr << "   -r selects the run manager type, tasking using the"
+           << " built-in thread pool and tbb the TBB one." << G4endl;
+    G4cerr << "   -g sets the number of events dispatched at once to a thread"
+           << " (task), as /run/eventModulo;" << G4endl;
+    G4cerr << "      0 lets the run manager choose it from the number of"
+           << " events." << G4endl;
+    G4cerr << "   -b sets the seeding: 0 per event, 1 per batch of events,"
+           << " 2 once per thread." << G4endl;
+    G4cerr << "   -r serial enables the multi-process mode of the /xray/fork/"
+           << " commands." << G4endl;
+    G4cerr << "   --shard runs the shard i (0 .. N-1) of a job of N shards,"
+           << " merged with xrayMerge." << G4endl;
+    G4cerr << "   -s selects the detector scoring: sensitive detector (default)"
+           << " or stepping action." << G4endl;
+    G4cerr << "   -p lite selects the minimal physics configuration: gamma, e-"
+           << " and e+ only, EM tables in 10 eV - 100 keV." << G4endl;
   }
 }
 
@@ -57,31 +95,89 @@ namespace {
 
 int main(int argc,char** argv)
 {
+  // Startup time of the physics configurations
+  XRayResourceUsage::Start();
+
   // Evaluate arguments
   //
-  if ( argc > 7 ) {
+  if ( argc > 21 ) {
     PrintUsage();
     return 1;
   }
   
   G4String macro;
   G4String session;
+  G4String scoring = "sd";
+  G4String physics = "full";
+  G4String runManagerType = "default";
+  G4int shard = -1;
+  G4int nofShards = 0;
 #ifdef G4MULTITHREADED
   G4int nThreads = 0;
+  G4bool autoThreads = false;
+  G4int eventModulo = -1;
+  G4int seedOnce = -1;
+  G4String pinning;
 #endif
   for ( G4int i=1; i<argc; i=i+2 ) {
     if      ( G4String(argv[i]) == "-m" ) macro = argv[i+1];
     else if ( G4String(argv[i]) == "-u" ) session = argv[i+1];
+    else if ( G4String(argv[i]) == "-s" ) scoring = argv[i+1];
+    else if ( G4String(argv[i]) == "-p" ) physics = argv[i+1];
+    else if ( G4String(argv[i]) == "-r" ) runManagerType = argv[i+1];
+    else if ( G4String(argv[i]) == "--shard" ) {
+      // i/N
+      G4String value = argv[i+1];
+      auto slash = value.find('/');
+      if ( slash != std::string::npos ) {
+        shard = G4UIcommand::ConvertToInt(value.substr(0, slash).c_str());
+        nofShards = G4UIcommand::ConvertToInt(value.substr(slash + 1).c_str());
+      }
+      if ( nofShards <= 0 || shard < 0 || shard >= nofShards ) {
+        PrintUsage();
+        return 1;
+      }
+    }
 #ifdef G4MULTITHREADED
     else if ( G4String(argv[i]) == "-t" ) {
-      nThreads = G4UIcommand::ConvertToInt(argv[i+1]);
+      autoThreads = ( G4String(argv[i+1]) == "auto" );
+      if ( ! autoThreads ) nThreads = G4UIcommand::ConvertToInt(argv[i+1]);
     }
+    else if ( G4String(argv[i]) == "-g" ) {
+      eventModulo = G4UIcommand::ConvertToInt(argv[i+1]);
+    }
+    else if ( G4String(argv[i]) == "-b" ) {
+      seedOnce = G4UIcommand::ConvertToInt(argv[i+1]);
+    }
+    else if ( G4String(argv[i]) == "--pin" ) pinning = argv[i+1];
 #endif
     else {
       PrintUsage();
       return 1;
     }
   }  
+  if ( ( scoring != "sd" && scoring != "step" ) 
+       || ( physics != "full" && physics != "lite" ) ) {
+    PrintUsage();
+    return 1;
+  }
+
+  // The run manager type, the requested one only
+  auto type = G4RunManagerType::Default;
+  if      ( runManagerType == "serial" )  type = G4RunManagerType::SerialOnly;
+  else if ( runManagerType == "mt" )      type = G4RunManagerType::MTOnly;
+  else if ( runManagerType == "tasking" ) type = G4RunManagerType::TaskingOnly;
+  else if ( runManagerType == "tbb" )     type = G4RunManagerType::TBBOnly;
+  else if ( runManagerType != "default" ) {
+    PrintUsage();
+    return 1;
+  }
+#ifdef G4MULTITHREADED
+  if ( pinning.size() && pinning != "compact" && pinning != "scatter" ) {
+    PrintUsage();
+    return 1;
+  }
+#endif
   
   // Detect interactive mode (if no macro provided) and define UI session
   //
@@ -94,26 +190,73 @@ int main(int argc,char** argv)
   //
   // G4Random::setTheEngine(new CLHEP::MTwistEngine);
   
-  // Construct the default run manager
+  // Construct the run manager
   //
-  auto* runManager =
-    G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
+  auto* runManager = G4RunManagerFactory::CreateRunManager(type);
 #ifdef G4MULTITHREADED
+  // The processor topology, for the automatic number of threads and pinning
+  XRayTopology topology;
+  if ( autoThreads ) {
+    nThreads = topology.IsEmpty() 
+             ? G4Threading::G4GetNumberOfCores() : topology.GetNofCores();
+    G4cout << "Using " << nThreads << " threads, one per physical core of "
+           << topology.GetNofNodes() << " NUMA node(s)" << G4endl;
+  }
   if ( nThreads > 0 ) { 
     runManager->SetNumberOfThreads(nThreads);
   }  
+
+  // Event dispatching of the MT and tasking run managers
+  auto mtRunManager = dynamic_cast<G4MTRunManager*>(runManager);
+  if ( mtRunManager ) {
+    if ( eventModulo >= 0 ) mtRunManager->SetEventModulo(eventModulo);
+    if ( seedOnce >= 0 ) G4MTRunManager::SetSeedOncePerCommunication(seedOnce);
+  }
+
+  // Pin the worker threads, which then allocate their data on their node
+  if ( mtRunManager && pinning.size() ) {
+    auto placement 
+      = topology.GetPlacement(pinning, mtRunManager->GetNumberOfThreads());
+    std::vector<G4int> nodes;
+    for ( auto cpu : placement ) nodes.push_back(topology.GetNode(cpu));
+    if ( placement.empty() ) {
+      G4cerr << "The processor topology is not available,"
+             << " the threads are not pinned." << G4endl;
+    }
+    else {
+      runManager->SetUserInitialization(
+        new XRayWorkerInitialization(placement, nodes));
+    }
+  }
 #endif
 
+  // Seeds and outputs of the shard, before the threads are started
+  //
+  if ( nofShards > 0 ) XRayShard::Configure(shard, nofShards);
+
   // Set mandatory initialization classes
   //
   auto detConstruction = new XRayDetectorConstruction();
+  detConstruction->SetSteppingScoring(scoring == "step");
   runManager->SetUserInitialization(detConstruction);
 
-  runManager->SetUserInitialization(new XRayPhysicsList());
+  runManager->SetUserInitialization(new XRayPhysicsList(physics == "lite"));
     
   auto actionInitialization = new XRayActionInitialization(detConstruction);
   runManager->SetUserInitialization(actionInitialization);
   
+  // Multi-process mode of the serial run manager
+  //
+  auto forkRunner = new XRayForkRunner();
+
+  // Parameter sweep in this process
+  //
+  auto sweep = new XRaySweep();
+
+  // Detector response matrix, built over an energy grid in this process
+  //
+  auto responseMatrix = new XRayResponseMatrix();
+
   // Initialize visualization
   //
   auto visManager = new G4VisExecutive;
@@ -147,6 +290,9 @@ int main(int argc,char** argv)
   // in the main() program !
 
   delete visManager;
+  delete responseMatrix;
+  delete sweep;
+  delete forkRunner;
   delete runManager;
 }
 
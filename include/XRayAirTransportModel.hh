@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayAirTransportModel.hh
+/// \brief Definition of the XRayAirTransportModel class
+
+#ifndef XRayAirTransportModel_h
+#define XRayAirTransportModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <map>
+
+class G4Material;
+class G4Navigator;
+class G4PhysicsLogVector;
+class XRayAttenuation;
+
+/// Fast transport of the photons through the air of the world 
+/// (/phys/airTransport weight|roulette).
+///
+/// The model is attached to the default region, i.e. the world, whose 
+/// target and detector daughters are regions of their own: a photon in
+/// the world is moved in one step, straight to the next volume boundary,
+/// without interaction. It stops a surface tolerance short of a daughter,
+/// whose entrance is left to the transportation: the sensitive detectors
+/// score the steps starting on a geometry boundary. The air attenuation
+/// over the path is applied to first order (Beer-Lambert), either to the
+/// weight ("weight") or with a Russian roulette ("roulette"), which keeps
+/// the photon with the probability of no interaction. A photon leaving the
+/// world is killed.
+///
+/// The attenuation coefficient of the world material is tabulated at the
+/// first use, from the cross sections per volume of the photon processes
+/// (XRayAttenuation), on a logarithmic grid over the EM tables range.
+///
+/// The scattered photons of the air and their fluorescence are thus
+/// neglected; the model is to be validated for a given setup by comparing
+/// the tallies with and without it (airBenchmark.mac).
+
+class XRayAirTransportModel : public G4VFastSimulationModel
+{
+  public:
+    XRayAirTransportModel(const G4String& name, G4Region* envelope,
+                          G4bool roulette);
+    virtual ~XRayAirTransportModel();
+
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  private:
+    G4double GetAttenuation(const G4Material* material, G4double energy);
+
+    G4bool          fRoulette;
+    G4Navigator*    fNavigator;  // of the mass geometry, for this model
+    XRayAttenuation* fCalculator;
+    std::map<const G4Material*, G4PhysicsLogVector*> fAttenuations;
+
+    // computed by ModelTrigger() for DoIt()
+    G4double        fDistance;
+    G4bool          fLeavingWorld;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
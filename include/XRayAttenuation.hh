@@ -0,0 +1,62 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayAttenuation.hh
+/// \brief Definition of the XRayAttenuation class
+
+#ifndef XRayAttenuation_h
+#define XRayAttenuation_h 1
+
+#include "globals.hh"
+
+class G4EmCalculator;
+class G4Material;
+
+/// Linear attenuation coefficient of the photons in a material: the sum of
+/// the cross sections per volume of the photo-electric effect, Compton and
+/// Rayleigh scatterings and pair conversion, computed with G4EmCalculator.
+///
+/// Shared by XRayNextEventEstimator and XRayAirTransportModel, which each
+/// cache the values as their use requires.
+
+class XRayAttenuation
+{
+  public:
+    XRayAttenuation();
+    ~XRayAttenuation();
+
+    XRayAttenuation(const XRayAttenuation&) = delete;
+    XRayAttenuation& operator=(const XRayAttenuation&) = delete;
+
+    G4double Compute(const G4Material* material, G4double energy);
+
+  private:
+    G4EmCalculator* fEmCalculator;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,143 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayBoundingBox.hh
+/// \brief Definition of the XRayBoundingBox class
+
+#ifndef XRayBoundingBox_h
+#define XRayBoundingBox_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "globals.hh"
+
+#include <algorithm>
+
+/// Axis-aligned bounding box in the world frame.
+///
+/// It is built from a physical volume placed in the world volume
+/// (the rotation of the placement is ignored), optionally enlarged by
+/// a margin. IsHitBy() is the analytic slab test of a half-line against 
+/// the box: the same three operations are done on each axis, without 
+/// divisions by zero, so that it can be used with FPE detection enabled.
+
+class XRayBoundingBox
+{
+  public:
+    XRayBoundingBox();
+
+    void Set(const G4VPhysicalVolume* volume, G4double margin = 0.);
+
+    G4bool Contains(const G4ThreeVector& point) const;
+    G4bool IsHitBy(const G4ThreeVector& origin, 
+                   const G4ThreeVector& direction) const;
+
+    G4ThreeVector GetCenter() const;
+    G4double GetRadius() const; // radius of the circumscribed sphere
+
+  private:
+    G4double fMin[3];
+    G4double fMax[3];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline XRayBoundingBox::XRayBoundingBox()
+{
+  for ( G4int i=0; i<3; ++i ) {
+    fMin[i] = 0.;
+    fMax[i] = 0.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void XRayBoundingBox::Set(const G4VPhysicalVolume* volume, 
+                                 G4double margin)
+{
+  G4ThreeVector pMin, pMax;
+  volume->GetLogicalVolume()->GetSolid()->BoundingLimits(pMin, pMax);
+  auto center = volume->GetTranslation();
+  for ( G4int i=0; i<3; ++i ) {
+    fMin[i] = center[i] + pMin[i] - margin;
+    fMax[i] = center[i] + pMax[i] + margin;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool XRayBoundingBox::Contains(const G4ThreeVector& point) const
+{
+  return point.x() >= fMin[0] && point.x() <= fMax[0]
+      && point.y() >= fMin[1] && point.y() <= fMax[1]
+      && point.z() >= fMin[2] && point.z() <= fMax[2];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool XRayBoundingBox::IsHitBy(const G4ThreeVector& origin, 
+                                       const G4ThreeVector& direction) const
+{
+  G4double tNear = 0.;
+  G4double tFar = DBL_MAX;
+  for ( G4int i=0; i<3; ++i ) {
+    // a direction parallel to the slab must start between its planes
+    if ( direction[i] == 0. ) {
+      if ( origin[i] < fMin[i] || origin[i] > fMax[i] ) return false;
+      continue;
+    }
+    auto invDir = 1./direction[i];
+    auto t1 = (fMin[i] - origin[i])*invDir;
+    auto t2 = (fMax[i] - origin[i])*invDir;
+    tNear = std::max(tNear, std::min(t1, t2));
+    tFar  = std::min(tFar,  std::max(t1, t2));
+  }
+  return tNear <= tFar;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4ThreeVector XRayBoundingBox::GetCenter() const
+{
+  return G4ThreeVector(0.5*(fMin[0] + fMax[0]), 
+                       0.5*(fMin[1] + fMax[1]), 
+                       0.5*(fMin[2] + fMax[2]));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4double XRayBoundingBox::GetRadius() const
+{
+  return 0.5*G4ThreeVector(fMax[0] - fMin[0], 
+                           fMax[1] - fMin[1], 
+                           fMax[2] - fMin[2]).mag();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayCulling.hh
+/// \brief Definition of the XRayCulling class
+
+#ifndef XRayCulling_h
+#define XRayCulling_h 1
+
+#include "G4VDiscreteProcess.hh"
+#include "XRayBoundingBox.hh"
+#include "globals.hh"
+
+class G4VPhysicalVolume;
+class XRayRunAction;
+
+/// Culling of the photons leaving the target (/xray/cull/active).
+///
+/// XRayStackingAction culls the new tracks only: the primaries crossing
+/// the target without interacting or after a Compton scattering, and the
+/// fluorescence photons of the target when it is not culled, keep their 
+/// track. The process is added to the gamma by XRayPhysicsList and 
+/// configured at each run by XRayStackingAction. On the first step of a 
+/// photon out of the target, it runs the ray-box test of the stacking 
+/// action on the detector bounding box, and kills the photon if it misses 
+/// it; the target being convex, the photon cannot come back to it.
+/// The tests are counted with XRayRunAction::CountCullingTest().
+///
+/// The track ID and the volume of the last step are kept to detect the 
+/// exit of the target, the tracks of a thread being processed one at a time.
+
+class XRayCulling : public G4VDiscreteProcess
+{
+  public:
+    XRayCulling(const G4String& processName = "culling");
+    ~XRayCulling();
+
+    G4bool IsApplicable(const G4ParticleDefinition&);
+    void   Configure(G4bool active, const G4VPhysicalVolume* targetPV,
+                     const XRayBoundingBox& detectorBox, 
+                     XRayRunAction* runAction);
+
+    G4double PostStepGetPhysicalInteractionLength(const G4Track& track,
+                                                  G4double previousStepSize,
+                                                  G4ForceCondition* condition);
+
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*)
+      {return DBL_MAX;};     // it is not needed here !
+
+  private:
+    G4bool   fActive;
+    const G4VPhysicalVolume* fTargetPV;
+    XRayBoundingBox fDetectorBox; // with the culling margin
+    XRayRunAction*  fRunAction;
+    G4int    fTrackID;  // of the last step
+    G4bool   fInTarget; // the last step was in the target
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -35,6 +35,7 @@
 
 class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
+class XRayDetectorMessenger;
 
 /// Detector construction class to define materials and geometry.
 /// The calorimeter is a box made of a given number of layers. A layer consists
@@ -49,6 +50,18 @@ class G4GlobalMagFieldMessenger;
 ///
 /// In addition a transverse uniform magnetic field is defined 
 /// via G4GlobalMagFieldMessenger class.
+///
+/// The photons entering the detector are scored with XRayDetectorSD,
+/// attached to the detector volume in ConstructSDandField(), unless the
+/// scoring in the stepping action was selected with SetSteppingScoring().
+///
+/// The target material and thickness can be changed between runs with the
+/// /xray/det/ commands (XRayDetectorMessenger): the thickness only modifies
+/// the geometry, the material also requires to rebuild the physics tables.
+///
+/// The target and the detector are the root volumes of the "Target" and
+/// "Detector" regions, for the production cuts and atomic deexcitation 
+/// per region of XRayPhysicsList; the world is the default region.
 
 class XRayDetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -58,11 +71,21 @@ class XRayDetectorConstruction : public G4VUserDetectorConstruction
 
   public:
     virtual G4VPhysicalVolume* Construct();
+    virtual void ConstructSDandField();
+
+    // set methods
+    //
+    void SetSteppingScoring(G4bool value);
+    void SetTargetMaterial(const G4String& name);
+    void SetTargetThickness(G4double value);
 
     // get methods
     //
     const G4VPhysicalVolume* GetTargetPV() const;
     const G4VPhysicalVolume* GetDetectorPV() const;
+    G4bool GetSteppingScoring() const;
+    const G4String& GetTargetMaterial() const;
+    G4double GetTargetThickness() const;
      
   private:
     // methods
@@ -75,10 +98,15 @@ class XRayDetectorConstruction : public G4VUserDetectorConstruction
     //static G4ThreadLocal G4GlobalMagFieldMessenger*  fMagFieldMessenger; 
                                       // magnetic field messenger
      
+    XRayDetectorMessenger* fMessenger;
+
     G4VPhysicalVolume*   fTargetPV; // the target physical volume
     G4VPhysicalVolume*   fDetectorPV;    // the gap physical volume
     
     G4bool  fCheckOverlaps; // option to activate checking of volumes overlaps
+    G4bool  fSteppingScoring; // option to score in the stepping action
+    G4String fTargetMaterial;   // NIST name of the target material
+    G4double fTargetThickness;
 };
 
 // inline functions
@@ -90,6 +118,22 @@ inline const G4VPhysicalVolume* XRayDetectorConstruction::GetTargetPV() const {
 inline const G4VPhysicalVolume* XRayDetectorConstruction::GetDetectorPV() const  { 
   return fDetectorPV; 
 }
+
+inline void XRayDetectorConstruction::SetSteppingScoring(G4bool value) {
+  fSteppingScoring = value;
+}
+
+inline G4bool XRayDetectorConstruction::GetSteppingScoring() const {
+  return fSteppingScoring;
+}
+
+inline const G4String& XRayDetectorConstruction::GetTargetMaterial() const {
+  return fTargetMaterial;
+}
+
+inline G4double XRayDetectorConstruction::GetTargetThickness() const {
+  return fTargetThickness;
+}
      
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
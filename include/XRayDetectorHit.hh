@@ -0,0 +1,149 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayDetectorHit.hh
+/// \brief Definition of the XRayDetectorHit class
+
+#ifndef XRayDetectorHit_h
+#define XRayDetectorHit_h 1
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "globals.hh"
+
+/// Detector hit class
+///
+/// It defines data members to store a particle entering the detector:
+/// - fTrackID, its track ID
+/// - fEnergy, its total energy
+/// - fWeight, its statistical weight (not 1 when biasing is active)
+/// - fFromPhot, whether it was created by the photo-electric effect 
+///
+/// The hits are allocated from a thread-local G4Allocator pool.
+
+class XRayDetectorHit : public G4VHit
+{
+  public:
+    XRayDetectorHit();
+    XRayDetectorHit(const XRayDetectorHit&);
+    virtual ~XRayDetectorHit();
+
+    // operators
+    const XRayDetectorHit& operator=(const XRayDetectorHit&);
+    G4bool operator==(const XRayDetectorHit&) const;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    // methods from base class
+    virtual void Draw() {}
+    virtual void Print();
+
+    // set methods
+    void SetTrackID(G4int trackID);
+    void SetEnergy(G4double energy);
+    void SetWeight(G4double weight);
+    void SetFromPhot(G4bool fromPhot);
+
+    // get methods
+    G4int    GetTrackID() const;
+    G4double GetEnergy() const;
+    G4double GetWeight() const;
+    G4bool   IsFromPhot() const;
+      
+  private:
+    G4int    fTrackID;
+    G4double fEnergy;
+    G4double fWeight;
+    G4bool   fFromPhot;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+using XRayDetectorHitsCollection = G4THitsCollection<XRayDetectorHit>;
+
+extern G4ThreadLocal G4Allocator<XRayDetectorHit>* XRayDetectorHitAllocator;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void* XRayDetectorHit::operator new(size_t)
+{
+  if (!XRayDetectorHitAllocator) {
+    XRayDetectorHitAllocator = new G4Allocator<XRayDetectorHit>;
+  }
+  void *hit;
+  hit = (void *) XRayDetectorHitAllocator->MallocSingle();
+  return hit;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void XRayDetectorHit::operator delete(void *hit)
+{
+  if (!XRayDetectorHitAllocator) {
+    XRayDetectorHitAllocator = new G4Allocator<XRayDetectorHit>;
+  }
+  XRayDetectorHitAllocator->FreeSingle((XRayDetectorHit*) hit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void XRayDetectorHit::SetTrackID(G4int trackID) {
+  fTrackID = trackID;
+}
+
+inline void XRayDetectorHit::SetEnergy(G4double energy) {
+  fEnergy = energy;
+}
+
+inline void XRayDetectorHit::SetWeight(G4double weight) {
+  fWeight = weight;
+}
+
+inline void XRayDetectorHit::SetFromPhot(G4bool fromPhot) {
+  fFromPhot = fromPhot;
+}
+
+inline G4int XRayDetectorHit::GetTrackID() const { 
+  return fTrackID; 
+}
+
+inline G4double XRayDetectorHit::GetEnergy() const { 
+  return fEnergy; 
+}
+
+inline G4double XRayDetectorHit::GetWeight() const { 
+  return fWeight; 
+}
+
+inline G4bool XRayDetectorHit::IsFromPhot() const { 
+  return fFromPhot; 
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayDetectorSD.hh
+/// \brief Definition of the XRayDetectorSD class
+
+#ifndef XRayDetectorSD_h
+#define XRayDetectorSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+
+#include "XRayDetectorHit.hh"
+
+#include <vector>
+
+class XRayStackingAction;
+class XRayEventAction;
+class G4Step;
+class G4HCofThisEvent;
+
+/// Detector sensitive detector class
+///
+/// In Initialize(), it creates one hits collection per event.
+/// In ProcessHits(), a hit is created for each particle entering 
+/// the detector volume, with its total energy at the entrance and 
+/// whether it was created by the photo-electric effect (or sampled as a
+/// fluorescence photon by XRayTargetResponseModel).
+/// The hits are scored in XRayEventAction::EndOfEventAction().
+///
+/// Once a photon and a fluorescence photon descending from each primary
+/// of the event have entered the detector, the tallies of the event cannot
+/// change anymore. In the "first-hit" mode of XRayStackingAction, the 
+/// current track is then killed and XRayStackingAction::DiscardEvent() 
+/// terminates the event.
+
+class XRayDetectorSD : public G4VSensitiveDetector
+{
+  public:
+    XRayDetectorSD(const G4String& name, 
+                   const G4String& hitsCollectionName);
+    virtual ~XRayDetectorSD();
+  
+    // methods from base class
+    virtual void   Initialize(G4HCofThisEvent* hitCollection);
+    virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
+    virtual void   EndOfEvent(G4HCofThisEvent* hitCollection);
+
+  private:
+    XRayDetectorHitsCollection* fHitsCollection;
+    XRayStackingAction* fStackingAction;
+    XRayEventAction*    fEventAction;
+    G4int   fPhotSubType; // sub-type of the photo-electric process
+    std::vector<G4int> fFilled; // per primary: kDet | kDetFluo when entered
+    G4int   fNofCompleted;      // number of primaries with both tallies
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,56 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayEmLitePhysics.hh
+/// \brief Definition of the XRayEmLitePhysics class
+
+#ifndef XRayEmLitePhysics_h
+#define XRayEmLitePhysics_h 1
+
+#include "G4VPhysicsConstructor.hh"
+#include "globals.hh"
+
+/// Electromagnetic physics of the "xray-lite" configuration of 
+/// XRayPhysicsList (exampleXRay -p lite): the Livermore models of the 
+/// photons, with the atomic deexcitation, and the electron and positron
+/// processes, for these three particles only. Unlike the Geant4 EM 
+/// constructors, it defines no process for the muons, hadrons and ions,
+/// which are not constructed in this configuration.
+
+class XRayEmLitePhysics : public G4VPhysicsConstructor
+{
+  public:
+    XRayEmLitePhysics(const G4String& name = "xray-lite");
+    virtual ~XRayEmLitePhysics();
+
+    virtual void ConstructParticle();
+    virtual void ConstructProcess();
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
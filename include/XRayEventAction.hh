@@ -31,43 +31,145 @@
 #define XRayEventAction_h 1
 
 #include "G4UserEventAction.hh"
+#include "G4Track.hh"
 #include "globals.hh"
 
+#include <chrono>
+#include <utility>
+#include <vector>
+
+class XRayRunAction;
+class G4Event;
+
 /// Event action class
 ///
-/// It defines data members to hold the energy deposit and track lengths
-/// of charged particles in Absober and Gap layers:
-/// - fEnergyAbs, fEnergyGap, fTrackLAbs, fTrackLGap
-/// which are collected step by step via the functions
-/// - AddAbs(), AddGap()
+/// It defines data members to hold, for each primary of the event, the energy
+/// of the first photon incident on the detector and of the first fluorescence
+/// photon:
+/// - fEnergyDet, fEnergyDetFluo
+/// with their statistical weights, fWeightDet, fWeightDetFluo,
+/// which are collected via the functions
+/// - AddDet(), AddDetFluo()
+/// either step by step by XRaySteppingAction, or from the hits of 
+/// XRayDetectorSD at the end of event.
+/// In the "all" scoring mode (/xray/scoring all, required by the biasing),
+/// set by XRayStackingAction with SetAdditiveScoring(), all the photons are
+/// instead scored with their weights, as (energy, weight) pairs: the 
+/// tallies then estimate the number of photons per primary, and no longer
+/// the probability that a primary gives one.
+///
+/// An event can carry several independent primaries (see the bunched mode
+/// of XRayPrimaryGeneratorAction): the tallies are then kept per primary,
+/// in flat arrays indexed by the primary, so that the histograms remain
+/// per photon. XRayStackingAction registers each new track with 
+/// RegisterTrack(), which records the primary it descends from in a flat 
+/// array indexed by the track ID, returned by GetPrimaryIndex().
+///
+/// The next-event estimates of the fluorescence photons, (energy, weight)
+/// pairs collected via AddDetFluoNEE() by XRayStackingAction, are all
+/// scored in the EDetFluoNEE histogram.
+///
+/// Per primary, the tallies estimate:
+/// - EDet: in the "first" mode, the probability that the primary gives a
+///   photon entering the detector, by the energy of the first one; in the
+///   "all" mode, the number of photons entering the detector
+/// - EDetFluo: the same, for the photons created by the photo-electric 
+///   effect, in the target or in the air
+/// - EDetFluoNEE: the number of fluorescence photons from the target 
+///   reaching the detector without interacting, always additive.
+/// EDetFluoNEE is thus compared with EDetFluo in the "all" mode, of which
+/// it leaves out the photons scattered on their way and the fluorescence
+/// of the air (see neeBenchmark.mac).
+///
+/// The histograms, and the weighted tallies estimating their statistical
+/// errors, are filled with the event ID via XRayRunAction::Fill().
+///
+/// The time spent from the beginning to the end of the event is given to
+/// XRayRunAction::AddEventTime(), for its breakdown of the run time.
 
 class XRayEventAction : public G4UserEventAction
 {
   public:
-    XRayEventAction();
+    XRayEventAction(XRayRunAction* runAction);
     virtual ~XRayEventAction();
 
     virtual void  BeginOfEventAction(const G4Event* event);
     virtual void    EndOfEventAction(const G4Event* event);
     
-    void AddDet(G4double E);
-    void AddDetFluo(G4double E);
+    void RegisterTrack(const G4Track* track);
+    G4int GetPrimaryIndex(G4int trackID) const;
+    G4int GetNofPrimaries() const;
+    static G4int CountPrimaries(const G4Event* event);
+
+    void AddDet(G4int primary, G4double E, G4double weight);
+    void AddDetFluo(G4int primary, G4double E, G4double weight);
+    void AddDetFluoNEE(G4double E, G4double weight);
+    void SetAdditiveScoring(G4bool value);
     
   private:
-    G4double  fEnergyDet;       // Energy incident on detector
-    G4double  fEnergyDetFluo;   // Energy incident on detector from fluorescence photon
+    XRayRunAction* fRunAction;
+    G4int     fDetHCID;         // Detector hits collection ID
+    G4int     fNofPrimaries;    // Number of primaries of the event
+    std::vector<G4int> fPrimaryOfTrack; // Primary index, by track ID
+    std::vector<G4double> fEnergyDet;     // Energy incident on detector
+    std::vector<G4double> fEnergyDetFluo; // Energy incident on detector from fluorescence photon
+    std::vector<G4double> fWeightDet;     // Weight of the photon incident on detector
+    std::vector<G4double> fWeightDetFluo; // Weight of the fluorescence photon incident on detector
+    std::vector<std::pair<G4double, G4double>> fDetFluoNEE; // next-event estimates
+    G4bool    fAdditiveScoring; // all the photons are scored
+    std::vector<std::pair<G4double, G4double>> fDetAll;     // additive scoring
+    std::vector<std::pair<G4double, G4double>> fDetFluoAll;
+    std::chrono::steady_clock::time_point fStartTime; // of the event
 };
 
 // inline functions
 
-inline void XRayEventAction::AddDet(G4double E) {
-  if(fEnergyDet == 0.)
-    fEnergyDet = E;
+inline void XRayEventAction::RegisterTrack(const G4Track* track) {
+  // The primaries have the track IDs 1 .. fNofPrimaries, 
+  // the parent of a secondary is registered before it
+  auto trackID = track->GetTrackID();
+  if ( trackID >= G4int(fPrimaryOfTrack.size()) ) 
+    fPrimaryOfTrack.resize(2*trackID, 0);
+  auto parentID = track->GetParentID();
+  fPrimaryOfTrack[trackID] 
+    = ( parentID == 0 ) ? trackID - 1 : fPrimaryOfTrack[parentID];
+}
+
+inline G4int XRayEventAction::GetPrimaryIndex(G4int trackID) const {
+  return ( trackID < G4int(fPrimaryOfTrack.size()) ) ? fPrimaryOfTrack[trackID] : 0;
+}
+
+inline G4int XRayEventAction::GetNofPrimaries() const {
+  return fNofPrimaries;
+}
+
+inline void XRayEventAction::AddDet(G4int primary, G4double E, G4double weight) {
+  if(fAdditiveScoring) {
+    fDetAll.push_back(std::make_pair(E, weight));
+  }
+  else if(primary < fNofPrimaries && fEnergyDet[primary] == 0.) {
+    fEnergyDet[primary] = E;
+    fWeightDet[primary] = weight;
+  }
+}
+
+inline void XRayEventAction::AddDetFluo(G4int primary, G4double E, G4double weight) {
+  if(fAdditiveScoring) {
+    fDetFluoAll.push_back(std::make_pair(E, weight));
+  }
+  else if(primary < fNofPrimaries && fEnergyDetFluo[primary] == 0.) {
+    fEnergyDetFluo[primary] = E;
+    fWeightDetFluo[primary] = weight;
+  }
+}
+
+inline void XRayEventAction::AddDetFluoNEE(G4double E, G4double weight) {
+  if(weight > 0.)
+    fDetFluoNEE.push_back(std::make_pair(E, weight));
 }
 
-inline void XRayEventAction::AddDetFluo(G4double E) {
-  if(fEnergyDetFluo == 0.)
-    fEnergyDetFluo = E;
+inline void XRayEventAction::SetAdditiveScoring(G4bool value) {
+  fAdditiveScoring = value;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
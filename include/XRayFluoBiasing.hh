@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayFluoBiasing.hh
+/// \brief Definition of the XRayFluoBiasing class
+
+#ifndef XRayFluoBiasing_h
+#define XRayFluoBiasing_h 1
+
+#include "G4VDiscreteProcess.hh"
+#include "XRayBoundingBox.hh"
+#include "globals.hh"
+
+class G4VPhysicalVolume;
+
+/// Biasing of the emission direction of the fluorescence photons created 
+/// by the photo-electric effect in the target (/phys/fluoBiasing).
+///
+/// The process is added to the gamma by XRayPhysicsList and configured 
+/// at each run by XRayStackingAction. It limits the first step of the
+/// fluorescence photons from the target to zero, and then re-emits them
+/// in the cone around the detector bounding sphere with the probability
+/// fFraction, and isotropically otherwise, the weight being multiplied by
+/// the ratio of the isotropic density to the density of this mixture.
+
+class XRayFluoBiasing : public G4VDiscreteProcess
+{
+  public:
+    XRayFluoBiasing(const G4String& processName = "fluoBiasing");
+    ~XRayFluoBiasing();
+
+    G4bool IsApplicable(const G4ParticleDefinition&);
+    void   Configure(G4double fraction, G4int photSubType,
+                     const G4VPhysicalVolume* targetPV,
+                     const G4VPhysicalVolume* detectorPV);
+
+    G4double PostStepGetPhysicalInteractionLength(const G4Track& track,
+                                                  G4double previousStepSize,
+                                                  G4ForceCondition* condition);
+
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*)
+      {return DBL_MAX;};     // it is not needed here !
+
+  private:
+    G4double fFraction;    // probability of the emission toward the detector
+    G4int    fPhotSubType; // sub-type of the photo-electric process
+    XRayBoundingBox fTargetBox;
+    XRayBoundingBox fDetectorBox;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
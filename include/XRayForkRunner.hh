@@ -0,0 +1,81 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayForkRunner.hh
+/// \brief Definition of the XRayForkRunner class
+
+#ifndef XRayForkRunner_h
+#define XRayForkRunner_h 1
+
+#include "globals.hh"
+
+class XRayForkMessenger;
+
+/// Multi-process mode of a serial run manager (exampleXRay -r serial).
+///
+/// BeamOn() first builds the physics tables with a run of no event, then
+/// forks fNofProcesses processes, which share the geometry and the tables
+/// copy-on-write instead of building them again. Each process gets its own
+/// MixMax stream, seeded with its index, the run ID and a seed drawn by the
+/// parent, and its own part of the primaries (phase-space records or Sobol
+/// points, XRayPrimaryGeneratorAction::SetProcess()). It runs its share of
+/// the events, with the run ID of the forked run, and writes its outputs
+/// with the suffix "_p<i>". It then copies its histograms, tallies
+/// and counters (XRayRunAction::ExportProcessData()) into its slot of an 
+/// anonymous shared memory mapping, and exits.
+///
+/// The parent waits for all the processes, and sums their slots into its 
+/// run action, which prints the statistics of the whole run and writes the
+/// merged outputs without suffix.
+///
+/// The mode is configured with the /xray/fork/ commands; it is available
+/// on POSIX systems, in batch mode.
+
+class XRayForkRunner
+{
+  public:
+    XRayForkRunner();
+    ~XRayForkRunner();
+
+    void BeamOn(G4int nofEvents);
+
+    void SetNofProcesses(G4int value);
+
+  private:
+    XRayForkMessenger* fMessenger;
+    G4int fNofProcesses;
+    G4int fNextRunID; // the run of no event does not advance the run ID
+};
+
+// inline functions
+
+inline void XRayForkRunner::SetNofProcesses(G4int value) {
+  fNofProcesses = value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
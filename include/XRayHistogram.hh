@@ -0,0 +1,258 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayHistogram.hh
+/// \brief Definition of the XRayHistogram class template
+
+#ifndef XRayHistogram_h
+#define XRayHistogram_h 1
+
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+#include "tools/histo/h1d"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/// Axis of the energy histograms: 0 - 7 keV
+
+struct XRayEnergyAxis
+{
+  static constexpr G4double Min() { return 0.; }
+  static constexpr G4double Max() { return 7.*keV; }
+};
+
+/// One-dimensional weighted histogram with a compile-time binning.
+///
+/// The N bins of Axis (plus the underflow and overflow bins) are stored as
+/// one 64-byte aligned array: each thread fills its own instance, without
+/// any lock, and the bin index costs one multiply.
+///
+/// The instances created on the worker threads are registered by id.
+/// At the end of run, Reduce() called on the master instance adds them to
+/// it, in a plain loop: a few thousand bins per worker take microseconds.
+/// Export() copies the bins to a histogram of the analysis manager of the
+/// master, so that it is written to the output file as before. CopyTo() and Add()
+/// give the bins as a flat array of doubles, which is how the runs of
+/// forked processes are summed (see XRayForkRunner).
+
+template <G4int N, typename Axis>
+class alignas(64) XRayHistogram
+{
+  public:
+    explicit XRayHistogram(G4int id);
+    ~XRayHistogram();
+
+    XRayHistogram(const XRayHistogram&) = delete;
+    XRayHistogram& operator=(const XRayHistogram&) = delete;
+
+    void Fill(G4double value, G4double weight = 1.);
+    void Reset();
+    void Add(const XRayHistogram& other);
+    void Reduce();
+    void Export(tools::histo::h1d& h1) const;
+
+    // number of bins, without the underflow and overflow
+    static constexpr G4int kNofBins = N;
+
+    // flat copy of the bins, to be summed across processes
+    static constexpr std::size_t GetDataSize() { return 5*(N + 2); }
+    void CopyTo(G4double* data) const;
+    void Add(const G4double* data);
+
+  private:
+    struct Bin 
+    {
+      G4double fEntries;
+      G4double fSw;
+      G4double fSw2;
+      G4double fSxw;
+      G4double fSx2w;
+    };
+
+    static constexpr G4double kScale = N/(Axis::Max() - Axis::Min());
+
+    static std::vector<std::vector<XRayHistogram*>>& Registry();
+    static std::mutex& RegistryMutex();
+
+    alignas(64) Bin fBins[N + 2]; // [0] underflow, [N+1] overflow
+    G4int  fId;
+    G4bool fRegistered;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+XRayHistogram<N, Axis>::XRayHistogram(G4int id)
+ : fId(id),
+   fRegistered(G4Threading::IsWorkerThread())
+{
+  Reset();
+
+  if ( fRegistered ) {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto& registry = Registry();
+    if ( G4int(registry.size()) <= fId ) registry.resize(fId + 1);
+    registry[fId].push_back(this);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+XRayHistogram<N, Axis>::~XRayHistogram()
+{
+  if ( fRegistered ) {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto& instances = Registry()[fId];
+    instances.erase(std::remove(instances.begin(), instances.end(), this),
+                    instances.end());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+inline void XRayHistogram<N, Axis>::Fill(G4double value, G4double weight)
+{
+  auto position = (value - Axis::Min())*kScale;
+  G4int bin = N + 1;
+  if ( position < 0. ) bin = 0;
+  else if ( position < N ) bin = std::min(G4int(position), N - 1) + 1;
+
+  auto& content = fBins[bin];
+  content.fEntries += 1.;
+  content.fSw   += weight;
+  content.fSw2  += weight*weight;
+  content.fSxw  += value*weight;
+  content.fSx2w += value*value*weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+void XRayHistogram<N, Axis>::Reset()
+{
+  std::fill(fBins, fBins + N + 2, Bin{0., 0., 0., 0., 0.});
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+void XRayHistogram<N, Axis>::Add(const XRayHistogram& other)
+{
+  for ( G4int i=0; i<N+2; ++i ) {
+    fBins[i].fEntries += other.fBins[i].fEntries;
+    fBins[i].fSw   += other.fBins[i].fSw;
+    fBins[i].fSw2  += other.fBins[i].fSw2;
+    fBins[i].fSxw  += other.fBins[i].fSxw;
+    fBins[i].fSx2w += other.fBins[i].fSx2w;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+void XRayHistogram<N, Axis>::CopyTo(G4double* data) const
+{
+  for ( G4int i=0; i<N+2; ++i ) {
+    *data++ = fBins[i].fEntries;
+    *data++ = fBins[i].fSw;
+    *data++ = fBins[i].fSw2;
+    *data++ = fBins[i].fSxw;
+    *data++ = fBins[i].fSx2w;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+void XRayHistogram<N, Axis>::Add(const G4double* data)
+{
+  for ( G4int i=0; i<N+2; ++i ) {
+    fBins[i].fEntries += *data++;
+    fBins[i].fSw   += *data++;
+    fBins[i].fSw2  += *data++;
+    fBins[i].fSxw  += *data++;
+    fBins[i].fSx2w += *data++;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+void XRayHistogram<N, Axis>::Reduce()
+{
+  // The workers have all finished their run when the master ends its run
+  std::vector<XRayHistogram*> instances;
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto& registry = Registry();
+    if ( G4int(registry.size()) > fId ) instances = registry[fId];
+  }
+  for ( auto instance : instances ) Add(*instance);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+void XRayHistogram<N, Axis>::Export(tools::histo::h1d& h1) const
+{
+  // The h1d bins are numbered as ours: 0 underflow, N+1 overflow
+  h1.reset();
+  for ( G4int i=0; i<N+2; ++i ) {
+    const auto& content = fBins[i];
+    h1.set_bin_content(i, std::size_t(content.fEntries), 
+                       content.fSw, content.fSw2, content.fSxw, content.fSx2w);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+std::vector<std::vector<XRayHistogram<N, Axis>*>>& 
+XRayHistogram<N, Axis>::Registry()
+{
+  static std::vector<std::vector<XRayHistogram*>> registry;
+  return registry;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <G4int N, typename Axis>
+std::mutex& XRayHistogram<N, Axis>::RegistryMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,90 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayNextEventEstimator.hh
+/// \brief Definition of the XRayNextEventEstimator class
+
+#ifndef XRayNextEventEstimator_h
+#define XRayNextEventEstimator_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <map>
+#include <utility>
+
+class XRayDetectorConstruction;
+class XRayAttenuation;
+class G4Material;
+class G4VSolid;
+
+/// Next-event estimator of the photons reaching the detector.
+///
+/// Estimate() returns the probability that a photon emitted isotropically
+/// at a given point of the target reaches the detector without interacting.
+/// The detector is seen as the rectangle of its bounding box normal to its
+/// thinnest side; a point is sampled uniformly on it, and the probability 
+/// is A cos(theta)/(4 pi r^2) exp(-mu_target l_target - mu_world l_world),
+/// where l_target is the path to the target surface and l_world the rest
+/// of the path in the world material.
+///
+/// The attenuation coefficients are computed with XRayAttenuation and 
+/// cached per material and energy, the fluorescence lines being discrete.
+///
+/// Summed over the fluorescence photons, the estimate is the expected 
+/// number of uncollided photons from the target entering the detector,
+/// the quantity of the analog EDetFluo tally in the "all" scoring mode,
+/// less the scattered photons.
+
+class XRayNextEventEstimator
+{
+  public:
+    XRayNextEventEstimator(const XRayDetectorConstruction* detConstruction);
+    ~XRayNextEventEstimator();
+
+    void     Prepare();
+    G4double Estimate(const G4ThreeVector& position, G4double energy);
+
+  private:
+    G4double GetAttenuation(const G4Material* material, G4double energy);
+
+    const XRayDetectorConstruction* fDetConstruction;
+    XRayAttenuation* fCalculator;
+    std::map<std::pair<const G4Material*, G4double>, G4double> fAttenuations;
+
+    // geometry, updated in Prepare() at the beginning of each run
+    const G4VSolid*    fTargetSolid;
+    G4ThreeVector      fTargetCenter;
+    const G4Material*  fTargetMaterial;
+    const G4Material*  fWorldMaterial;
+    G4ThreeVector      fDetCenter;
+    G4int              fDetNormalAxis;
+    G4double           fDetHalfSizes[3];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
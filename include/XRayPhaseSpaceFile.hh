@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayPhaseSpaceFile.hh
+/// \brief Definition of the XRayPhaseSpaceFile class
+
+#ifndef XRayPhaseSpaceFile_h
+#define XRayPhaseSpaceFile_h 1
+
+#include "XRayPhaseSpaceFormat.hh"
+#include "globals.hh"
+
+#include <cstddef>
+
+/// Read-only memory mapping of a phase-space file (XRayPhaseSpaceFormat.hh).
+///
+/// The records are read in place: each thread maps the file, the pages 
+/// being shared by the page cache, and reads its own range of records.
+/// Advise() tells the kernel that a range is read sequentially.
+
+class XRayPhaseSpaceFile
+{
+  public:
+    XRayPhaseSpaceFile();
+    ~XRayPhaseSpaceFile();
+
+    XRayPhaseSpaceFile(const XRayPhaseSpaceFile&) = delete;
+    XRayPhaseSpaceFile& operator=(const XRayPhaseSpaceFile&) = delete;
+
+    G4bool Open(const G4String& fileName);
+    void Close();
+    void Advise(std::uint64_t first, std::uint64_t last) const;
+
+    G4bool IsOpen() const;
+    std::uint64_t GetNofRecords() const;
+    const XRayPhaseSpaceRecord* GetRecords() const;
+
+  private:
+    void*        fData;
+    std::size_t  fSize;
+    std::uint64_t fNofRecords;
+    const XRayPhaseSpaceRecord* fRecords;
+};
+
+// inline functions
+
+inline G4bool XRayPhaseSpaceFile::IsOpen() const {
+  return fData != nullptr;
+}
+
+inline std::uint64_t XRayPhaseSpaceFile::GetNofRecords() const {
+  return fNofRecords;
+}
+
+inline const XRayPhaseSpaceRecord* XRayPhaseSpaceFile::GetRecords() const {
+  return fRecords;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,62 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayPhaseSpaceFormat.hh
+/// \brief Definition of the XRay phase-space file format
+
+#ifndef XRayPhaseSpaceFormat_h
+#define XRayPhaseSpaceFormat_h 1
+
+#include <cstdint>
+
+/// Binary phase-space file: a header followed by fixed-size records, 
+/// in the native byte order. The positions are in mm, the energies in keV.
+/// This header does not depend on Geant4, so that it is shared with
+/// the converter in tools/.
+
+struct XRayPhaseSpaceHeader
+{
+  char          fMagic[4];     // "XRPS"
+  std::uint32_t fVersion;      // 1
+  std::uint64_t fNofRecords;
+};
+
+struct XRayPhaseSpaceRecord
+{
+  float fPosition[3];
+  float fDirection[3];
+  float fEnergy;
+  float fWeight;
+};
+
+static_assert(sizeof(XRayPhaseSpaceHeader) == 16, "unexpected header padding");
+static_assert(sizeof(XRayPhaseSpaceRecord) == 32, "unexpected record padding");
+
+const std::uint32_t kXRayPhaseSpaceVersion = 1;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -35,15 +35,41 @@
 #include "G4VModularPhysicsList.hh"
 #include "globals.hh"
 
+#include <vector>
+
 class G4VPhysicsConstructor;
+class G4ProductionCuts;
 class XRayPhysicsListMessenger;
+class XRayPhysicsTableCache;
+class XRayTargetResponse;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+/// With lite (exampleXRay -p lite), the "xray-lite" configuration constructs
+/// only the gamma, e-, e+ and geantinos, with XRayEmLitePhysics and without
+/// the decay and step limitation processes, and restricts the EM tables to
+/// 10 eV - 100 keV by default (/process/eLoss/minKinEnergy, maxKinEnergy
+/// and binsPerDecade set the window and binning).
+///
+/// The cuts and the atomic deexcitation can be set per region ("Target",
+/// "Detector" of XRayDetectorConstruction, or "World"), so that the fine
+/// physics is only applied in the target and detector: the region cuts 
+/// override the global ones, and once a region has its own deexcitation
+/// flags, the deexcitation is only active in the regions given so.
+///
+/// With an air transport mode ("weight" or "roulette"), the photons cross
+/// the world in one step with XRayAirTransportModel, attached to the world
+/// region by XRayDetectorConstruction.
+///
+/// The target response mode "build" fills an XRayTargetResponse table
+/// during the runs, written in the response file at the end of each run;
+/// the mode "use" reads it and replaces the full simulation of the target
+/// by XRayTargetResponseModel.
+
 class XRayPhysicsList: public G4VModularPhysicsList
 {
 public:
-  XRayPhysicsList();
+  XRayPhysicsList(G4bool lite = false);
   virtual ~XRayPhysicsList();
 
   void ConstructParticle();
@@ -61,19 +87,83 @@ public:
   void SetCutForProton(G4double);
   void SetFluorescence(G4bool);
   void SetPIXE(G4bool);
+  void SetForceCollision(G4bool);
+  void SetAirTransport(const G4String& mode);
+  void SetTargetResponse(const G4String& mode, const G4String& fileName);
+  void SetTargetResponseRange(G4double emin, G4double emax);
+  void SetFluoBiasing(G4double);
+  void SetTableCache(const G4String& directory);
+  void SetCutForRegion(const G4String& region, const G4String& particle,
+                       G4double cut);
+  void SetDeexcitation(const G4String& region, 
+                       G4bool fluo, G4bool auger, G4bool pixe);
+
+  const G4String& GetEmName() const { return emName; };
+  G4bool IsLite() const { return lite; };
+  G4bool GetForceCollision() const { return forceCollision; };
+  const G4String& GetAirTransport() const { return airTransport; };
+  const G4String& GetTargetResponseMode() const { return responseMode; };
+  const G4String& GetTargetResponseFile() const { return responseFile; };
+  G4double GetTargetResponseEmin() const { return responseEmin; };
+  G4double GetTargetResponseEmax() const { return responseEmax; };
+  const XRayTargetResponse* GetTargetResponse() const { return targetResponse; };
+  G4double GetFluoBiasing() const;
     
 private:
 
   XRayPhysicsListMessenger* pMessenger; 
 
+  // minimal particle set and processes of the X-ray simulation
+  G4bool lite;
+
   G4String emName;
   G4VPhysicsConstructor* emPhysicsList;
+
+  // generic biasing of gamma, needed by the forced collision in the target
+  G4bool forceCollision;
+  G4VPhysicsConstructor* biasingPhysics;
+
+  // fast transport of the gamma through the world: "none", "weight" 
+  // or "roulette"
+  G4String airTransport;
+  G4VPhysicsConstructor* fastSimulationPhysics;
+
+  // target response table: "none", "build" or "use" (read, then shared 
+  // by the models of all the threads)
+  G4String responseMode;
+  G4String responseFile;
+  G4double responseEmin;
+  G4double responseEmax;
+  XRayTargetResponse* targetResponse;
+
+  void UpdateFastSimulation();
+
+  // fraction of the fluorescence photons emitted toward the detector,
+  // used with the Livermore and Penelope constructors only
+  G4double fluoBiasing;
   
   G4double cutForGamma;
   G4double cutForElectron;
   G4double cutForPositron;    
   G4double cutForProton;    
 
+  // physics tables stored and retrieved in a directory
+  XRayPhysicsTableCache* tableCache;
+
+  // cuts per region, applied again at each initialization
+  struct RegionCut {
+    G4String region;
+    G4String particle;
+    G4double cut;
+  };
+  std::vector<RegionCut> regionCuts;
+
+  G4bool ApplyCutForRegion(const RegionCut& regionCut, G4bool verbose);
+
+  // regions with their own deexcitation flags, which need their own cuts
+  std::vector<G4String> deexRegions;
+
+  G4ProductionCuts* GetOwnCuts(const G4String& region);
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -37,8 +37,10 @@
 
 class XRayPhysicsList;
 class G4UIdirectory;
+class G4UIcommand;
 class G4UIcmdWithAString;
 class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
 class G4UIcmdWithADoubleAndUnit;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -64,6 +66,15 @@ private:
   G4UIcmdWithADoubleAndUnit* allCutCmd;        
   G4UIcmdWithABool*          fluoCmd;
   G4UIcmdWithABool*          pixeCmd;
+  G4UIcmdWithABool*          forceCollisionCmd;
+  G4UIcmdWithAString*        airTransportCmd;
+  G4UIcmdWithADouble*        fluoBiasingCmd;
+  G4UIcmdWithAString*        tableCacheCmd;
+  G4UIcommand*               regionGCutCmd;
+  G4UIcommand*               regionECutCmd;
+  G4UIcommand*               deexcitationCmd;
+  G4UIcommand*               targetResponseCmd;
+  G4UIcommand*               responseRangeCmd;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,89 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayPhysicsTableCache.hh
+/// \brief Definition of the XRayPhysicsTableCache class
+
+#ifndef XRayPhysicsTableCache_h
+#define XRayPhysicsTableCache_h 1
+
+#include "G4VStateDependent.hh"
+#include "G4Timer.hh"
+#include "globals.hh"
+
+class XRayPhysicsList;
+
+/// Cache of the physics tables in a directory (/phys/tableCache).
+///
+/// The physics tables are built at the initialization of the first run,
+/// and again when the materials or the cuts change. This class follows
+/// the states of the master: at the start of a run initialization 
+/// (Idle -> Init), it computes the key of the tables, made of the Geant4
+/// version, the EM constructor and parameters, the materials and the cuts
+/// of the regions. If the entry of the key, a sub-directory named by its 
+/// hash, holds complete tables, they are retrieved 
+/// (G4VUserPhysicsList::SetPhysicsTableRetrieved()) instead of built. At the 
+/// end of the run initialization (Idle -> GeomClosed), tables just built
+/// are stored in a new entry (StorePhysicsTable()).
+///
+/// The entry is complete once its key file, written last with the key
+/// and the time the tables took to build, is there: the key is checked 
+/// in full at the retrieval, so that a change of configuration always
+/// builds new tables. The time of the run initialization with retrieved
+/// tables is printed next to the build time.
+/// Several processes should not fill the same entry at the same time:
+/// the cache is best filled by a single process before a job array.
+
+class XRayPhysicsTableCache : public G4VStateDependent
+{
+  public:
+    XRayPhysicsTableCache(XRayPhysicsList* physicsList);
+    virtual ~XRayPhysicsTableCache();
+
+    virtual G4bool Notify(G4ApplicationState requestedState);
+
+    void SetDirectory(const G4String& directory);
+
+  private:
+    G4String ComputeKey() const;
+    G4bool   IsStored(G4double& buildTime) const;
+    void     Store(G4double buildTime);
+
+    XRayPhysicsList* fPhysicsList;
+    G4String fDirectory;   // empty: no cache
+    G4String fKey;         // key of the current run initialization
+    G4String fEntry;       // its directory
+    G4String fBuiltKey;    // key of the tables in memory
+    G4bool   fPending;     // in a run initialization
+    G4bool   fRetrieved;
+    G4double fBuildTime;   // stored with the retrieved tables [s]
+    G4Timer  fTimer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
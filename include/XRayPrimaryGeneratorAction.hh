@@ -31,10 +31,17 @@
 #define XRayPrimaryGeneratorAction_h 1
 
 #include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4ThreeVector.hh"
+#include "XRaySpectrum.hh"
+#include "XRayPhaseSpaceFile.hh"
+#include "XRaySobol.hh"
 #include "globals.hh"
 
+#include <vector>
+
 class G4ParticleGun;
 class G4Event;
+class XRayPrimaryGeneratorMessenger;
 
 /// The primary generator action class with particle gum.
 ///
@@ -42,6 +49,51 @@ class G4Event;
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class 
 /// (see the macros provided with this example).
+///
+/// The kinematics of the primaries are pre-sampled for blocks of 
+/// fBatchSize events into a structure-of-arrays buffer, from one bulk 
+/// draw of random numbers, and handed out event by event. The gun position
+/// is spread over a disc of fSpotSize diameter and its direction within a 
+/// cone of fDivergence half-angle, around the G4ParticleGun settings.
+/// As a block spans several events, the primaries of an event depend
+/// on the random stream of the event which filled the block: the default
+/// batch size of 1 keeps the per-event reproducibility in MT mode, and the
+/// batching is enabled with /xray/gun/batchSize.
+///
+/// The energy is either the G4ParticleGun one ("mono" spectrum), or sampled
+/// from an XRaySpectrum read from a file ("file") or built from the X-ray 
+/// tube model ("tube"), prepared at the beginning of the run which follows
+/// a change of its settings.
+///
+/// With the "phaseSpace" source, the primaries are instead read from a
+/// memory-mapped phase-space file (XRayPhaseSpaceFile), partitioned over
+/// the shards of a job (XRayShard) and the processes forked by 
+/// XRayForkRunner (SetProcess()). The threads of a process take blocks of
+/// its range of records from a shared cursor, so that each record is used
+/// once however the events are dispatched to the threads. A record can be
+/// used fRecycle times in a row, and rotated by a random angle around the z
+/// axis at each use. A process which runs out of records aborts the run,
+/// unless their reuse from the first one is allowed (SetWrap()).
+/// The record weight is given to the primary.
+///
+/// The random numbers of the gun source (spot, direction and energy) come
+/// from the engine ("pseudo" sampler), or from a scrambled Sobol sequence 
+/// (XRaySobol, "sobol" sampler): the scrambling is drawn from fSobolSeed
+/// and the run ID, the same on all threads, and each thread skips ahead
+/// to its own block of 2^32/n points, n being the number of parts of the
+/// run (shards x processes x threads) rounded up to a power of two.
+/// The rest of the event remains pseudo-random.
+///
+/// An event can carry fPrimariesPerEvent independent primaries, one
+/// vertex each, so that the per-event overhead of the kernel is shared
+/// by several photons; XRayEventAction keeps the tallies per primary.
+///
+/// The world volume is checked once per run, in BeginOfRun() called by
+/// XRayRunAction, which also prints the generation time per event when the
+/// timing is enabled. A run whose gun energy or spectrum exceeds the upper
+/// limit of the EM tables (100 keV with the lite physics) is refused.
+///
+/// The source is configured with the /xray/gun/ commands.
 
 class XRayPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -50,14 +102,170 @@ public:
   virtual ~XRayPrimaryGeneratorAction();
 
   virtual void GeneratePrimaries(G4Event* event);
+
+  void BeginOfRun();
   
   // set methods
   void SetRandomFlag(G4bool value);
+  void SetSpotSize(G4double value);
+  void SetDivergence(G4double value);
+  void SetBatchSize(G4int value);
+  void SetPrimariesPerEvent(G4int value);
+  void SetTiming(G4bool value);
+  void SetSpectrum(const G4String& mode);
+  void SetSpectrumFile(const G4String& fileName);
+  void SetTubeVoltage(G4double value);
+  void SetTubeAnode(const G4String& anode);
+  void SetSource(const G4String& source);
+  void SetPhaseSpaceFile(const G4String& fileName);
+  void SetRecycle(G4int value);
+  void SetRotate(G4bool value);
+  void SetWrap(G4bool value);
+  void SetSampler(const G4String& sampler);
+  void SetSobolSeed(G4long value);
+  void SetProcess(G4int index, G4int nofProcesses);
+
+  // get methods
+  G4double GetGenerationTime() const;
+  G4long   GetNofGenerated() const;
+  G4bool   IsQuasiRandom() const;
 
 private:
+  void FillBuffer();
+  void PrepareSpectrum();
+  void PreparePhaseSpace();
+  void PrepareSobol();
+  void CheckEnergyRange() const;
+  void GetPartition(std::uint64_t& part, std::uint64_t& nofParts,
+                    G4bool perThread = true) const;
+  void FillBufferFromPhaseSpace(std::size_t size);
+  void ClaimRecords();
+
   G4ParticleGun*  fParticleGun; // G4 particle gun
+  XRayPrimaryGeneratorMessenger* fMessenger;
+
+  G4double  fSpotSize;   // diameter of the source spot
+  G4double  fDivergence; // half-angle of the beam cone
+  G4int     fBatchSize;  // number of primaries sampled at once
+  G4int     fPrimariesPerEvent;
+  G4bool    fTiming;     // option to time the generation
+
+  XRaySpectrum fSpectrum;
+  G4String  fSpectrumMode;    // mono, file or tube
+  G4String  fSpectrumFile;
+  G4double  fTubeVoltage;
+  G4String  fTubeAnode;
+  G4bool    fSpectrumChanged; // the spectrum is prepared at the next run
+
+  XRayPhaseSpaceFile fPhaseSpace;
+  G4String  fSource;            // gun or phaseSpace
+  G4String  fPhaseSpaceFile;
+  G4bool    fPhaseSpaceChanged; // the file is mapped at the next run
+  G4int     fRecycle;           // number of uses of each record
+  G4bool    fRotate;            // option to rotate the records around z
+  G4bool    fWrap;              // option to reuse the records
+  std::uint64_t fRangeBegin;    // range of records of this process
+  std::uint64_t fRangeEnd;
+  std::uint64_t fRecordBlock;   // records claimed at once by a thread
+  std::uint64_t fRecordNext;    // block of records of this thread
+  std::uint64_t fRecordEnd;
+  G4int     fRecordUses;        // uses of the next record
+
+  XRaySobol fSobol;
+  G4String  fSampler;           // pseudo or sobol
+  G4long    fSobolSeed;
+  std::uint32_t fSobolBegin;    // block of points of this thread
+  std::uint32_t fSobolEnd;
+
+  G4int     fProcess;           // forked process (XRayForkRunner)
+  G4int     fNofProcesses;
+
+  // structure-of-arrays buffer of the pre-sampled primaries
+  std::vector<G4double> fPosX, fPosY, fPosZ;
+  std::vector<G4double> fDirX, fDirY, fDirZ;
+  std::vector<G4double> fEnergy;
+  std::vector<G4double> fWeight;
+  std::vector<G4double> fRandoms;
+  std::size_t fNext;     // next primary to hand out
+
+  G4double  fGenerationTime; // time spent in GeneratePrimaries() [s]
+  G4long    fNofGenerated;   // number of timed events
 };
 
+// inline functions
+
+inline void XRayPrimaryGeneratorAction::SetPrimariesPerEvent(G4int value) {
+  fPrimariesPerEvent = value;
+}
+
+inline void XRayPrimaryGeneratorAction::SetTiming(G4bool value) {
+  fTiming = value;
+}
+
+inline void XRayPrimaryGeneratorAction::SetSpectrum(const G4String& mode) {
+  fSpectrumMode = mode;
+  fSpectrumChanged = true;
+}
+
+inline void XRayPrimaryGeneratorAction::SetSpectrumFile(const G4String& fileName) {
+  fSpectrumFile = fileName;
+  fSpectrumChanged = true;
+}
+
+inline void XRayPrimaryGeneratorAction::SetTubeVoltage(G4double value) {
+  fTubeVoltage = value;
+  fSpectrumChanged = true;
+}
+
+inline void XRayPrimaryGeneratorAction::SetTubeAnode(const G4String& anode) {
+  fTubeAnode = anode;
+  fSpectrumChanged = true;
+}
+
+inline void XRayPrimaryGeneratorAction::SetSource(const G4String& source) {
+  fSource = source;
+  fNext = fEnergy.size();
+}
+
+inline void XRayPrimaryGeneratorAction::SetPhaseSpaceFile(const G4String& fileName) {
+  fPhaseSpaceFile = fileName;
+  fPhaseSpaceChanged = true;
+}
+
+inline void XRayPrimaryGeneratorAction::SetRecycle(G4int value) {
+  fRecycle = value;
+}
+
+inline void XRayPrimaryGeneratorAction::SetRotate(G4bool value) {
+  fRotate = value;
+}
+
+inline void XRayPrimaryGeneratorAction::SetWrap(G4bool value) {
+  fWrap = value;
+}
+
+inline void XRayPrimaryGeneratorAction::SetSampler(const G4String& sampler) {
+  fSampler = sampler;
+  fNext = fEnergy.size();
+}
+
+inline void XRayPrimaryGeneratorAction::SetSobolSeed(G4long value) {
+  fSobolSeed = value;
+}
+
+inline G4bool XRayPrimaryGeneratorAction::IsQuasiRandom() const {
+  return fSampler == "sobol" 
+         && ! ( fSource == "phaseSpace" && fPhaseSpace.IsOpen() );
+}
+
+inline G4double XRayPrimaryGeneratorAction::GetGenerationTime() const {
+  return fGenerationTime;
+}
+
+inline G4long XRayPrimaryGeneratorAction::GetNofGenerated() const {
+  return fNofGenerated;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #endif
@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayPrimaryGeneratorMessenger.hh
+/// \brief Definition of the XRayPrimaryGeneratorMessenger class
+
+#ifndef XRayPrimaryGeneratorMessenger_h
+#define XRayPrimaryGeneratorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class XRayPrimaryGeneratorAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class XRayPrimaryGeneratorMessenger: public G4UImessenger
+{
+  public:
+    XRayPrimaryGeneratorMessenger(XRayPrimaryGeneratorAction*);
+    virtual ~XRayPrimaryGeneratorMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+    XRayPrimaryGeneratorAction*  fPrimaryGenerator;
+
+    G4UIdirectory*              fGunDir;
+    G4UIcmdWithADoubleAndUnit*  fSpotSizeCmd;
+    G4UIcmdWithADoubleAndUnit*  fDivergenceCmd;
+    G4UIcmdWithAnInteger*       fBatchSizeCmd;
+    G4UIcmdWithAnInteger*       fPrimariesPerEventCmd;
+    G4UIcmdWithABool*           fTimingCmd;
+    G4UIcmdWithAString*         fSpectrumCmd;
+    G4UIcmdWithAString*         fSpectrumFileCmd;
+    G4UIcmdWithADoubleAndUnit*  fTubeVoltageCmd;
+    G4UIcmdWithAString*         fTubeAnodeCmd;
+    G4UIcmdWithAString*         fSourceCmd;
+    G4UIcmdWithAString*         fSamplerCmd;
+    G4UIcmdWithAnInteger*       fSobolSeedCmd;
+
+    G4UIdirectory*              fPhaseSpaceDir;
+    G4UIcmdWithAString*         fPhaseSpaceFileCmd;
+    G4UIcmdWithAnInteger*       fRecycleCmd;
+    G4UIcmdWithABool*           fRotateCmd;
+    G4UIcmdWithABool*           fWrapCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
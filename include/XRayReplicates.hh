@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayReplicates.hh
+/// \brief Definition of the XRayReplicates class
+
+#ifndef XRayReplicates_h
+#define XRayReplicates_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+/// Run-to-run statistics of the tallies, by sampler of the primaries.
+///
+/// The master XRayRunAction adds the per-bin means of its tallies at the
+/// end of each run, with the sampler of the run ("pseudo" or "sobol") and
+/// its number of events. As every run of a scrambled Sobol sequence is an
+/// independent randomisation, the variance of each bin over the replicated
+/// runs is an unbiased estimate for both samplers, where the batch means 
+/// of a run would not be for the quasi-random one.
+///
+/// Write() compares the two samplers at equal numbers of events, once both
+/// have at least two runs: it prints the variance summed over the bins of
+/// each tally and its ratio pseudo/sobol (the variance reduction), and 
+/// writes the per-bin variances in a csv file.
+
+class XRayReplicates
+{
+  public:
+    XRayReplicates();
+    ~XRayReplicates();
+
+    void AddRun(const G4String& sampler, G4int nofEvents,
+                const std::vector<std::vector<G4double>>& means);
+    void Write(const std::vector<G4String>& names, 
+               const G4String& fileName) const;
+
+  private:
+    struct Sample {
+      Sample() : fNofRuns(0) {}
+      G4int fNofRuns;
+      std::vector<std::vector<G4double>> fSum;  // by tally, by bin
+      std::vector<std::vector<G4double>> fSum2;
+    };
+
+    static G4double Variance(const Sample& sample, std::size_t tally,
+                             std::size_t bin);
+
+    std::map<std::pair<G4int, G4String>, Sample> fSamples;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
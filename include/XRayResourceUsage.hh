@@ -0,0 +1,64 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayResourceUsage.hh
+/// \brief Definition of the XRayResourceUsage class
+
+#ifndef XRayResourceUsage_h
+#define XRayResourceUsage_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+
+/// Startup time and memory of the process.
+///
+/// Start() is called first thing in main(); PrintStartup(), called by the
+/// master at the beginning of its first run, once the physics tables are
+/// built, prints the time elapsed since then and the resident memory, 
+/// read from /proc/self/status (Linux), or the peak one from getrusage()
+/// on other POSIX systems. They compare the physics configurations of 
+/// exampleXRay -p.
+
+class XRayResourceUsage
+{
+  public:
+    static void Start();
+    static void PrintStartup();
+
+    static G4double GetElapsedTime();        // [s] since Start()
+    static G4double GetResidentMemory();     // [MB], 0 if not available
+    static G4double GetPeakResidentMemory(); // [MB], 0 if not available
+
+  private:
+    static std::chrono::steady_clock::time_point fStart;
+    static G4bool fStartupPrinted;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayResponseFormat.hh
+/// \brief Definition of the XRay response matrix file format
+
+#ifndef XRayResponseFormat_h
+#define XRayResponseFormat_h 1
+
+#include <cstdint>
+
+/// Binary response matrix file, written by XRayResponseMatrix in the 
+/// native byte order:
+/// - the header, which describes the incident energy grid (rows) and
+///   the detector axis of the tallies (columns)
+/// - the names of the matrices, kXRayResponseNameLength characters each,
+///   one per tally (EDet, EDetFluo, ...)
+/// - the fNofEnergies incident energies [keV], doubles
+/// - for each matrix, the fNofEnergies x fNofBins means per primary of
+///   the tally bins, then their relative errors, doubles, row by row
+/// The rows are independent runs, so that the errors of a folded 
+/// spectrum are summed in quadrature. This header does not depend on 
+/// Geant4, so that it is shared with the folding tool in tools/.
+
+struct XRayResponseHeader
+{
+  char          fMagic[4];     // "XRRM"
+  std::uint32_t fVersion;      // 1
+  std::uint32_t fNofEnergies;  // incident energies, rows
+  std::uint32_t fNofBins;      // detector bins, columns
+  std::uint32_t fNofMatrices;  // one per tally
+  std::uint32_t fReserved;
+  std::int64_t  fNofEvents;    // per incident energy
+  double        fMin;          // detector axis [keV]
+  double        fMax;
+};
+
+static_assert(sizeof(XRayResponseHeader) == 48, "unexpected header padding");
+
+const std::uint32_t kXRayResponseVersion = 1;
+const std::uint32_t kXRayResponseNameLength = 32;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
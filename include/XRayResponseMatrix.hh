@@ -0,0 +1,81 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayResponseMatrix.hh
+/// \brief Definition of the XRayResponseMatrix class
+
+#ifndef XRayResponseMatrix_h
+#define XRayResponseMatrix_h 1
+
+#include "globals.hh"
+
+class XRayResponseMatrixMessenger;
+
+/// Builder of the detector response matrix.
+///
+/// BeamOn() runs the given number of events of monoenergetic primaries at
+/// each energy of a linear grid (/xray/matrix/grid), the gun being set to
+/// its mono spectrum and the energy with /gun/energy, as a sweep would do.
+/// After each run, the per-primary means of the tallies of XRayRunAction
+/// (EDet, EDetFluo, ...) and their relative errors make a row of the 
+/// matrix of each tally, R[E_in][E_det].
+///
+/// The matrices are written in a binary file (XRayResponseFormat.hh), 
+/// XRay_response.xrrm by default, which tools/xrayFold folds with any 
+/// source spectrum, instead of a full simulation per spectrum. The grid
+/// should be fine enough for the linear interpolation between its rows:
+/// the absorption edges of the target and the detector move the response.
+///
+/// The builder is configured with the /xray/matrix/ commands.
+
+class XRayResponseMatrix
+{
+  public:
+    XRayResponseMatrix();
+    ~XRayResponseMatrix();
+
+    void SetGrid(G4double emin, G4double emax, G4int nofEnergies);
+    void SetFileName(const G4String& fileName);
+    void BeamOn(G4int nofEvents);
+
+  private:
+    XRayResponseMatrixMessenger* fMessenger;
+    G4double fEmin;
+    G4double fEmax;
+    G4int    fNofEnergies;
+    G4String fFileName;
+};
+
+// inline functions
+
+inline void XRayResponseMatrix::SetFileName(const G4String& fileName) {
+  fFileName = fileName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -31,9 +31,23 @@
 #define XRayRunAction_h 1
 
 #include "G4UserRunAction.hh"
+#include "G4Accumulable.hh"
+#include "G4Timer.hh"
+#include "XRayTally.hh"
+#include "XRayHistogram.hh"
+#include "XRayReplicates.hh"
+#include "XRayThreadStatistics.hh"
+#include "XRayTargetResponse.hh"
 #include "globals.hh"
 
+#include <vector>
+
 class G4Run;
+class XRaySteppingAction;
+class XRayPrimaryGeneratorAction;
+class XRayStackingAction;
+
+using XRayEnergyHistogram = XRayHistogram<1000, XRayEnergyAxis>;
 
 /// Run action class
 ///
@@ -52,6 +66,73 @@ class G4Run;
 /// In EndOfRunAction(), the accumulated statistic and computed 
 /// dispersion is printed.
 ///
+/// The run is also timed and the event and step throughput is printed 
+/// for each thread and for the entire run. The number of steps is taken
+/// from the stepping action, if one is set with SetSteppingAction().
+/// The cost of the primary generation per event is printed as well, when
+/// XRayPrimaryGeneratorAction (set with SetPrimaryGeneratorAction()) is timed.
+/// In the "first-hit" mode of XRayStackingAction, the number of terminated
+/// events and of skipped tracks is printed as well, and so is the fraction
+/// of the tracks culled by its geometric acceptance tests, on the new 
+/// neutral tracks and on the photons leaving the target (XRayCulling).
+/// The stacking action, set with SetStackingAction(), is prepared once per
+/// run in BeginOfRunAction().
+///
+/// The histograms are filled via Fill() in thread-local XRayHistogram 
+/// instances, reduced into the master one and exported to the histograms
+/// of the analysis manager at the end of run.
+///
+/// Each histogram is doubled by a weighted XRayTally with the same binning,
+/// filled together with it. At the end of run, the master prints the mean per
+/// primary photon of each tally (an event can carry several primaries,
+/// counted with AddPrimaries()) with its batch-means relative error R and
+/// the figure of merit 1/(R^2 T), T being the run real time, and writes the per-bin
+/// values and errors in the XRay_tallies.csv file next to the histograms.
+/// Both give the scoring mode of the detector tallies of the run (the 
+/// first photon of each primary, or all of them: /xray/scoring), taken 
+/// from the stacking action of the workers.
+///
+/// The run time is broken down, summed over the threads which processed
+/// events, into the time within the events (XRayEventAction), the time of
+/// the event loops outside of them (dispatching, seeding and generation of
+/// the primaries), and the time the threads waited for work or for the end 
+/// of the run; the event dispatching is set with the run manager type and
+/// the event modulo of the exampleXRay options, or /run/eventModulo.
+/// The throughput of each thread, with the CPU it ran on, is printed as
+/// well (XRayThreadStatistics).
+///
+/// The master also keeps the per-bin means of the tallies over the runs,
+/// by sampler of the primaries (XRayReplicates): after replicated runs with
+/// the "pseudo" and "sobol" samplers at the same number of events, it prints
+/// the variances of both and writes them in XRay_samplers.csv.
+///
+/// In the multi-process mode (XRayForkRunner), each forked process writes
+/// its outputs with "_p<i>" appended to the suffix of its shard 
+/// (SetForkedProcess()), but no shard file, and gives its 
+/// histograms, tallies and counters as a flat array (ExportProcessData()).
+/// The parent process adds them to its run action with ImportProcessData()
+/// between BeginOfRunAction() and EndOfRunAction(), which then reports the
+/// events and the real time of the forked run given by SetForkedRun().
+///
+/// In a sharded job (XRayShard), the event IDs of the tallies are offset
+/// to the range of the shard, and the master writes the same values in a
+/// shard file at the end of each run (WriteShard()); with forked processes,
+/// only the parent, which merges them, writes it.
+///
+/// In a parameter sweep (XRaySweep), the outputs of each point get the
+/// label of the point after the suffix of the process or shard.
+///
+/// GetTallyMeans() gives the per-primary means of the tallies of the last
+/// run, from which XRayResponseMatrix builds the detector response matrix.
+///
+/// When the target response table is built (/phys/targetResponse build),
+/// the XRayTargetResponse accumulable filled by XRayTargetResponseSD is 
+/// booked at the beginning of each run and written by the master at its
+/// end, with the suffix and the ID of the run before the extension of the
+/// file (one table per run, the table being reset at each run), and
+/// the target material and thickness in its header. When a table is used,
+/// the master refuses to start a run if it was built for another target
+/// (CheckTargetResponse()), after a change of the target as well.
 
 class XRayRunAction : public G4UserRunAction
 {
@@ -61,8 +142,130 @@ class XRayRunAction : public G4UserRunAction
 
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
+
+    void SetSteppingAction(XRaySteppingAction* steppingAction);
+    void SetPrimaryGeneratorAction(XRayPrimaryGeneratorAction* primaryGenerator);
+    void SetStackingAction(XRayStackingAction* stackingAction);
+    void AddSkippedTracks(G4long n);
+    void CountTerminatedEvent();
+    void CountCullingTest(G4bool culled);
+    void Fill(G4int id, G4int eventID, G4double value, G4double weight);
+    void AddPrimaries(G4int n);
+    void AddEventTime(G4double seconds);
+
+    // multi-process mode
+    void SetForkedProcess(G4int process);
+    void SetForkedRun(G4int nofEvents, G4double realTime);
+    std::size_t GetProcessDataSize() const;
+    void ExportProcessData(G4double* data) const;
+    void ImportProcessData(const G4double* data);
+
+    // the tallies of the last run, per primary (master)
+    G4int GetNofTallies() const;
+    const XRayTally* GetTally(G4int id) const;
+    void GetTallyMeans(G4int id, std::vector<G4double>& means,
+                       std::vector<G4double>& relErrors) const;
+
+  private:
+    XRaySteppingAction*    fSteppingAction;
+    XRayPrimaryGeneratorAction* fPrimaryGenerator;
+    XRayStackingAction*    fStackingAction;
+    G4Accumulable<G4long>  fNofSteps;
+    G4Accumulable<G4long>  fNofSkippedTracks;
+    G4Accumulable<G4long>  fNofTerminatedEvents;
+    G4Accumulable<G4long>  fNofCullingTests;
+    G4Accumulable<G4long>  fNofCulledTracks;
+    G4Accumulable<G4double> fGenerationTime;
+    G4Accumulable<G4long>  fNofGenerated;
+    G4Accumulable<G4long>  fNofPrimaries;
+    G4Accumulable<G4int>   fNofQuasiRandom; // threads with the Sobol sampler
+    G4Accumulable<G4int>   fNofAdditiveScoring; // threads scoring all photons
+    G4Accumulable<G4double> fEventTime;  // time within the events [s]
+    G4Accumulable<G4double> fThreadTime; // run time of the event loops [s]
+    G4Accumulable<G4int>   fNofThreads;  // threads which processed events
+    XRayThreadStatistics   fThreadStatistics;
+    XRayTargetResponse     fTargetResponse; // built with /phys/targetResponse
+    G4Timer                fTimer;
+    G4String               fOutputSuffix;
+    G4int                  fEventIDOffset;  // of the shard, modulo the batches
+    G4bool                 fForkedProcess;  // run in a forked process
+    G4int                  fForkedEvents;   // events of the forked processes
+    G4double               fForkedRealTime;
+    G4int                  fLastNofEvents;  // of the last run
+    G4double               fLastPrimariesPerEvent;
+    std::vector<XRayEnergyHistogram*> fHistograms;
+    std::vector<XRayTally*> fTallies; // one per histogram
+    XRayReplicates         fReplicates; // run-to-run statistics (master)
+
+    void WriteTallies(G4int nofEvents, G4long nofPrimaries, 
+                      G4double realTime) const;
+    void AddReplicate(G4int nofEvents, G4long nofPrimaries);
+    void WriteShard(const G4Run* run, G4int nofEvents, G4double realTime) const;
+    void CheckTargetResponse() const;
+    void WriteTargetResponse(const G4Run* run);
+    G4String GetRunSuffix() const;
 };
 
+// inline functions
+
+inline void XRayRunAction::SetSteppingAction(XRaySteppingAction* steppingAction) {
+  fSteppingAction = steppingAction;
+}
+
+inline void XRayRunAction::SetPrimaryGeneratorAction(
+                             XRayPrimaryGeneratorAction* primaryGenerator) {
+  fPrimaryGenerator = primaryGenerator;
+}
+
+inline void XRayRunAction::SetStackingAction(XRayStackingAction* stackingAction) {
+  fStackingAction = stackingAction;
+}
+
+inline void XRayRunAction::AddSkippedTracks(G4long n) {
+  fNofSkippedTracks += n;
+}
+
+inline void XRayRunAction::AddPrimaries(G4int n) {
+  fNofPrimaries += n;
+}
+
+inline void XRayRunAction::AddEventTime(G4double seconds) {
+  fEventTime += seconds;
+}
+
+inline G4int XRayRunAction::GetNofTallies() const {
+  return fTallies.size();
+}
+
+inline const XRayTally* XRayRunAction::GetTally(G4int id) const {
+  return fTallies[id];
+}
+
+inline void XRayRunAction::SetForkedProcess(G4int process) {
+  fOutputSuffix += "_p" + std::to_string(process);
+  fForkedProcess = true;
+}
+
+inline void XRayRunAction::SetForkedRun(G4int nofEvents, G4double realTime) {
+  fForkedEvents = nofEvents;
+  fForkedRealTime = realTime;
+}
+
+inline void XRayRunAction::CountTerminatedEvent() {
+  fNofTerminatedEvents += 1;
+}
+
+inline void XRayRunAction::CountCullingTest(G4bool culled) {
+  fNofCullingTests += 1;
+  if ( culled ) fNofCulledTracks += 1;
+}
+
+inline void XRayRunAction::Fill(G4int id, G4int eventID, 
+                                G4double value, G4double weight) {
+  fHistograms[id]->Fill(value, weight);
+  fTallies[id]->Fill(eventID + fEventIDOffset, value, weight);
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #endif
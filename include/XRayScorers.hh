@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayScorers.hh
+/// \brief Definition of the compile-time detector scorer set
+
+#ifndef XRayScorers_h
+#define XRayScorers_h 1
+
+#include "XRayEventAction.hh"
+#include "globals.hh"
+
+/// Description of a photon entering the detector, as handed to the scorers.
+
+struct XRayDetectorEntry
+{
+  G4int    fPrimary;  // index of the primary of the event it descends from
+  G4double fEnergy;   // total energy of the particle
+  G4double fWeight;   // statistical weight of the particle
+  G4bool   fFromPhot; // created by the photo-electric effect (fluorescence)
+};
+
+/// Detector scorers.
+///
+/// Each scorer is a stateless policy with a static Score() function.
+/// XRayScorerSet chains a list of scorers at compile time, so that the
+/// dispatch from the stepping action is fully inlined and the scorers 
+/// which are not used cost nothing.
+
+struct XRayDetScorer
+{
+  static void Score(XRayEventAction* eventAction, const XRayDetectorEntry& entry)
+  { 
+    eventAction->AddDet(entry.fPrimary, entry.fEnergy, entry.fWeight); 
+  }
+};
+
+struct XRayDetFluoScorer
+{
+  static void Score(XRayEventAction* eventAction, const XRayDetectorEntry& entry)
+  { 
+    if ( entry.fFromPhot ) eventAction->AddDetFluo(entry.fPrimary, entry.fEnergy, entry.fWeight); 
+  }
+};
+
+template <typename... Scorers>
+struct XRayScorerSet;
+
+template <>
+struct XRayScorerSet<>
+{
+  static void Score(XRayEventAction*, const XRayDetectorEntry&) {}
+};
+
+template <typename First, typename... Rest>
+struct XRayScorerSet<First, Rest...>
+{
+  static void Score(XRayEventAction* eventAction, const XRayDetectorEntry& entry)
+  {
+    First::Score(eventAction, entry);
+    XRayScorerSet<Rest...>::Score(eventAction, entry);
+  }
+};
+
+/// The scorers filling the EDet and EDetFluo histograms
+
+using XRayDefaultScorers = XRayScorerSet<XRayDetScorer, XRayDetFluoScorer>;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayShard.hh
+/// \brief Definition of the XRayShard class
+
+#ifndef XRayShard_h
+#define XRayShard_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+
+/// Shard of a job array (exampleXRay --shard i/N).
+///
+/// Configure(), called by the main program before the run manager starts
+/// the threads, seeds the engine with (i+1, N): the MixMax engine maps such
+/// a seed pair to one of its non-colliding streams, so that the shards
+/// draw disjoint random sequences. The events of a run of n events get 
+/// the IDs i*n .. (i+1)*n - 1 in the tallies (GetEventIDOffset()), so that 
+/// the merged tallies have the batches of a single run of N*n events.
+///
+/// The outputs of the shard have the suffix "_shard<i>", and the master 
+/// XRayRunAction writes a self-describing shard file 
+/// (XRayShardFormat.hh) per run, XRay_shard<i>_run<r>.xrsh, merged by
+/// tools/xrayMerge.
+/// ComputeConfigHash() hashes the UI commands applied so far, which are 
+/// the same for all the shards of a job: Configure() lifts the limit of
+/// the UI history, so that it keeps the commands of the whole session.
+/// The shard index is also the outermost level of the partition of the 
+/// primaries (XRayPrimaryGeneratorAction), so that the shards read 
+/// disjoint phase-space records and Sobol points.
+
+class XRayShard
+{
+  public:
+    static void Configure(G4int index, G4int nofShards);
+
+    static G4bool IsEnabled();
+    static G4int  GetIndex();
+    static G4int  GetNofShards();
+    static const long* GetSeeds();
+    static G4String GetSuffix();
+    static G4long GetEventIDOffset(G4int nofEvents);
+    static std::uint64_t ComputeConfigHash();
+
+  private:
+    static G4int fIndex;
+    static G4int fNofShards;
+    static long  fSeeds[3];
+};
+
+// inline functions
+
+inline G4bool XRayShard::IsEnabled() {
+  return fNofShards > 0;
+}
+
+inline G4int XRayShard::GetIndex() {
+  return fIndex;
+}
+
+inline G4int XRayShard::GetNofShards() {
+  return fNofShards;
+}
+
+inline const long* XRayShard::GetSeeds() {
+  return fSeeds;
+}
+
+inline G4long XRayShard::GetEventIDOffset(G4int nofEvents) {
+  return IsEnabled() ? G4long(fIndex)*nofEvents : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,83 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayShardFormat.hh
+/// \brief Definition of the XRay shard file format
+
+#ifndef XRayShardFormat_h
+#define XRayShardFormat_h 1
+
+#include <cstdint>
+
+/// Binary shard file, written by the master at the end of each run of a
+/// sharded job (exampleXRay --shard i/N), in the native byte order:
+/// - the header, which describes the job (configuration hash, shard index
+///   and seeds, events) and the layout of the values
+/// - the names of the histograms, kXRayShardNameLength characters each;
+///   the tallies are booked one to one with the histograms and share them
+/// - fNofValues doubles: the kXRayShardNofCounters counters (primaries,
+///   steps, skipped tracks, terminated events, culling tests, culled 
+///   tracks, generation time [s], timed events, quasi-random runs, 
+///   additive scoring runs), then for each histogram its 
+///   fNofHistogramBins + 2 bins (with the underflow and overflow) of 5 sums
+///   (entries, sw, sw2, sxw, sx2w), then for each tally its 
+///   fNofBatches x fNofTallyBins sums
+/// All the values are sums over the events, so that the shards are merged
+/// by adding them. This header does not depend on Geant4, so that it is 
+/// shared with the merge tool in tools/.
+
+struct XRayShardHeader
+{
+  char          fMagic[4];     // "XRSH"
+  std::uint32_t fVersion;      // 3
+  std::uint32_t fShard;        // index, or kXRayMergedShard
+  std::uint32_t fNofShards;
+  std::uint64_t fConfigHash;   // hash of the UI commands of the job
+  std::int64_t  fSeeds[2];
+  std::int64_t  fNofEvents;
+  std::int64_t  fFirstEventID;
+  std::uint32_t fNofMerged;    // number of shards summed in the file
+  std::uint32_t fNofHistograms;
+  std::uint32_t fNofHistogramBins;
+  std::uint32_t fNofTallies;
+  std::uint32_t fNofTallyBins;
+  std::uint32_t fNofBatches;
+  double        fMin;          // axis of the histograms and tallies [keV]
+  double        fMax;
+  double        fRealTime;     // [s], summed over the merged shards
+  std::uint64_t fNofValues;
+};
+
+static_assert(sizeof(XRayShardHeader) == 112, "unexpected header padding");
+
+const std::uint32_t kXRayShardVersion = 3;
+const std::uint32_t kXRayMergedShard = 0xffffffff;
+const std::uint32_t kXRayShardNameLength = 32;
+const std::uint32_t kXRayShardNofCounters = 10;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
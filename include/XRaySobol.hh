@@ -0,0 +1,97 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRaySobol.hh
+/// \brief Definition of the XRaySobol class
+
+#ifndef XRaySobol_h
+#define XRaySobol_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+
+/// Scrambled Sobol sequence in the kNofDimensions dimensions of the
+/// primary kinematics (spot, direction and energy), with 32-bit points.
+///
+/// The direction numbers are the Joe-Kuo ones. Scramble() applies a random
+/// linear matrix scrambling and a random digital shift to them, drawn from
+/// a seed and the run ID: all threads of a run share the same scrambled
+/// sequence, and each run is an independent randomisation of it, so that
+/// the variance can be estimated from replicated runs.
+///
+/// Skip() jumps to any index of the sequence in constant time (Gray code),
+/// which lets each thread draw its own contiguous block of points; Next()
+/// then returns the following points, one XOR per dimension.
+
+class XRaySobol
+{
+  public:
+    static const G4int kNofDimensions = 6;
+
+    XRaySobol();
+    ~XRaySobol();
+
+    void Scramble(G4long seed, G4int runID);
+    void Skip(std::uint32_t index);
+    void Next(G4double* point);
+
+    std::uint32_t GetIndex() const;
+
+  private:
+    static const G4int kNofBits = 32;
+
+    std::uint32_t fDirections[kNofDimensions][kNofBits];
+    std::uint32_t fShift[kNofDimensions];
+    std::uint32_t fState[kNofDimensions];
+    std::uint32_t fIndex;
+};
+
+// inline functions
+
+inline void XRaySobol::Next(G4double* point)
+{
+  for ( G4int d=0; d<kNofDimensions; ++d ) {
+    point[d] = ((fState[d] ^ fShift[d]) + 0.5)*(1./4294967296.);
+  }
+
+  // Gray code: the next point differs by the direction number 
+  // of the lowest zero bit of the index
+  G4int bit = 0;
+  for ( auto index = fIndex; index & 1u; index >>= 1 ) ++bit;
+  if ( bit < kNofBits ) {
+    for ( G4int d=0; d<kNofDimensions; ++d ) fState[d] ^= fDirections[d][bit];
+  }
+  ++fIndex;
+}
+
+inline std::uint32_t XRaySobol::GetIndex() const {
+  return fIndex;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
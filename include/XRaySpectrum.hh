@@ -0,0 +1,106 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRaySpectrum.hh
+/// \brief Definition of the XRaySpectrum class
+
+#ifndef XRaySpectrum_h
+#define XRaySpectrum_h 1
+
+#include "globals.hh"
+
+#include <algorithm>
+#include <vector>
+
+/// Energy spectrum of the primary photons, sampled in constant time.
+///
+/// The spectrum is a list of bins [low, high] with an intensity; a bin with
+/// low == high is a line. It can be read from a file, or built from a simple
+/// X-ray tube model:
+/// - file: the text and binary formats of XRaySpectrumFormat.hh, whose
+///   malformed rows or records reject the file
+/// - tube model: Kramers' bremsstrahlung continuum of an anode at a given 
+///   voltage, plus the K (and L for W) lines of the anode with the 
+///   (U-1)^1.63 dependence on the overvoltage U. This is a rough model, 
+///   without filtration nor self-absorption.
+///
+/// Prepare() builds a Walker alias table (Vose's algorithm), then Sample()
+/// picks a bin with one random number and the energy in the bin with another.
+
+class XRaySpectrum
+{
+  public:
+    XRaySpectrum();
+    ~XRaySpectrum();
+
+    void Clear();
+    void AddBin(G4double low, G4double high, G4double intensity);
+    G4bool LoadFile(const G4String& fileName);
+    G4bool BuildTube(G4double voltage, const G4String& anode);
+    void Prepare();
+
+    G4double Sample(G4double random1, G4double random2) const;
+
+    G4bool IsEmpty() const;
+    G4double GetMeanEnergy() const;
+    G4double GetMaxEnergy() const;
+
+  private:
+    std::vector<G4double> fLow;
+    std::vector<G4double> fWidth;
+    std::vector<G4double> fIntensity;
+
+    // alias table
+    std::vector<G4double> fProbability;
+    std::vector<G4int>    fAlias;
+};
+
+// inline functions
+
+inline G4double XRaySpectrum::Sample(G4double random1, G4double random2) const
+{
+  const G4int nofBins = fProbability.size();
+  auto position = random1*nofBins;
+  auto bin = std::min(G4int(position), nofBins - 1);
+  if ( position - bin >= fProbability[bin] ) bin = fAlias[bin];
+  return fLow[bin] + random2*fWidth[bin];
+}
+
+inline G4bool XRaySpectrum::IsEmpty() const {
+  return fProbability.empty();
+}
+
+inline G4double XRaySpectrum::GetMaxEnergy() const {
+  G4double maxEnergy = 0.;
+  for ( std::size_t i=0; i<fLow.size(); ++i ) {
+    maxEnergy = std::max(maxEnergy, fLow[i] + fWidth[i]);
+  }
+  return maxEnergy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
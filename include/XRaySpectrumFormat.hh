@@ -0,0 +1,208 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRaySpectrumFormat.hh
+/// \brief Definition of the XRay spectrum file formats
+
+#ifndef XRaySpectrumFormat_h
+#define XRaySpectrumFormat_h 1
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Spectrum files of /xray/gun/spectrumFile and of the folding tool, with
+/// the energies in keV:
+/// - text, 2 columns "energy intensity": the energies are bin centers,
+///   the bins extending to the middle of the neighbouring energies
+/// - text, 3 columns "low high intensity", a bin with low == high being
+///   a line; '#' starts a comment
+/// - binary (.bin extension), records of 3 doubles "low high intensity",
+///   in the native byte order
+/// The rows and records must be finite, non-negative numbers with 
+/// ascending energies: ReadXRaySpectrum() rejects a file with a malformed
+/// one, or with a truncated record, and gives the line or record in the
+/// error message. This header does not depend on Geant4, so that it is 
+/// shared with the folding tool in tools/.
+
+struct XRaySpectrumBin
+{
+  double fLow;       // [keV]
+  double fHigh;      // [keV]
+  double fIntensity;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Reason why a row "energy intensity" or "low high intensity" is rejected,
+/// given the previous row (or nullptr); nullptr if it is valid
+
+inline const char* CheckXRaySpectrumRow(const double* row, std::size_t size,
+                                        const double* previous)
+{
+  for ( std::size_t i=0; i<size; ++i ) {
+    if ( ! std::isfinite(row[i]) ) return "not a finite number";
+    if ( row[i] < 0. ) return "negative value";
+  }
+  if ( size == 3 && row[1] < row[0] ) return "bin high edge below its low edge";
+  // two bins may start at the same energy (a line and a bin), two centers
+  // may not
+  if ( previous && ( row[0] < previous[0] || 
+                     ( size == 2 && row[0] == previous[0] ) ) ) {
+    return "energies not in ascending order";
+  }
+  return nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline bool ReadXRaySpectrumBinary(const std::string& fileName,
+                                   std::vector<XRaySpectrumBin>& bins,
+                                   std::string& error)
+{
+  std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+  if ( ! file ) {
+    error = "cannot open " + fileName;
+    return false;
+  }
+
+  auto reject = [&](std::size_t index, const char* reason) {
+    error = fileName + ", record " + std::to_string(index) + ": " + reason;
+    return false;
+  };
+
+  const std::size_t recordSize = 3*sizeof(double);
+  const std::size_t size = file.tellg();
+  if ( size % recordSize != 0 ) {
+    return reject(size/recordSize, "truncated record at the end of the file");
+  }
+  file.seekg(0);
+
+  std::vector<double> records(size/sizeof(double));
+  if ( ! file.read(reinterpret_cast<char*>(records.data()), size) ) {
+    error = "cannot read " + fileName;
+    return false;
+  }
+  for ( std::size_t i=0; i<records.size()/3; ++i ) {
+    const auto record = records.data() + 3*i;
+    auto reason 
+      = CheckXRaySpectrumRow(record, 3, ( i > 0 ) ? record - 3 : nullptr);
+    if ( reason ) return reject(i, reason);
+    bins.push_back(XRaySpectrumBin{record[0], record[1], record[2]});
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline bool ReadXRaySpectrumText(const std::string& fileName,
+                                 std::vector<XRaySpectrumBin>& bins,
+                                 std::string& error)
+{
+  std::ifstream file(fileName);
+  if ( ! file ) {
+    error = "cannot open " + fileName;
+    return false;
+  }
+
+  auto reject = [&](int lineNumber, const char* reason) {
+    error = fileName + ", line " + std::to_string(lineNumber) + ": " + reason;
+    return false;
+  };
+
+  std::vector<std::vector<double>> rows;
+  std::string line;
+  int lineNumber = 0;
+  while ( std::getline(file, line) ) {
+    ++lineNumber;
+    auto comment = line.find('#');
+    if ( comment != std::string::npos ) line.erase(comment);
+    std::istringstream stream(line);
+    std::vector<double> row;
+    double value;
+    while ( stream >> value ) row.push_back(value);
+    if ( ! stream.eof() ) return reject(lineNumber, "not a number");
+    if ( row.empty() ) continue;
+    if ( row.size() < 2 || row.size() > 3 
+         || ( ! rows.empty() && row.size() != rows[0].size() ) ) {
+      return reject(lineNumber, "expected 2 or 3 columns, as the first row");
+    }
+    auto reason = CheckXRaySpectrumRow(row.data(), row.size(), 
+                    rows.empty() ? nullptr : rows.back().data());
+    if ( reason ) return reject(lineNumber, reason);
+    rows.push_back(row);
+  }
+
+  // Explicit bins
+  if ( ! rows.empty() && rows[0].size() == 3 ) {
+    for ( const auto& row : rows ) {
+      bins.push_back(XRaySpectrumBin{row[0], row[1], row[2]});
+    }
+    return true;
+  }
+
+  // Bin centers, extending to the middle of the neighbours
+  for ( std::size_t i=0; i<rows.size(); ++i ) {
+    auto energy = rows[i][0];
+    auto low  = ( i > 0 ) ? 0.5*(rows[i-1][0] + energy) : energy;
+    auto high = ( i+1 < rows.size() ) ? 0.5*(energy + rows[i+1][0]) : energy;
+    if ( i == 0 && rows.size() > 1 ) low = std::max(0., energy - (high - energy));
+    if ( i+1 == rows.size() && rows.size() > 1 ) high = energy + (energy - low);
+    bins.push_back(XRaySpectrumBin{low, high, rows[i][1]});
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Reads the bins of a spectrum file, in the format given by its extension;
+/// returns false, with the reason in error, if it is missing or malformed,
+/// or holds no bin
+
+inline bool ReadXRaySpectrum(const std::string& fileName,
+                             std::vector<XRaySpectrumBin>& bins,
+                             std::string& error)
+{
+  bins.clear();
+  auto dot = fileName.find_last_of('.');
+  auto binary = ( dot != std::string::npos && fileName.substr(dot + 1) == "bin" );
+  auto read = binary ? ReadXRaySpectrumBinary(fileName, bins, error)
+                     : ReadXRaySpectrumText(fileName, bins, error);
+  if ( read && bins.empty() ) {
+    error = "no bin in " + fileName;
+    read = false;
+  }
+  if ( ! read ) bins.clear();
+  return read;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,190 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayStackingAction.hh
+/// \brief Definition of the XRayStackingAction class
+
+#ifndef XRayStackingAction_h
+#define XRayStackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "XRayBoundingBox.hh"
+#include "globals.hh"
+
+class XRayDetectorConstruction;
+class XRayRunAction;
+class XRayEventAction;
+class XRayNextEventEstimator;
+class XRayStackingMessenger;
+
+/// Stacking action class
+///
+/// In the "first-hit" mode, the event is terminated as soon as all 
+/// detector tallies of the event are filled: XRayDetectorSD then calls
+/// DiscardEvent(), which drops the tracks waiting in the stacks, and the
+/// new tracks are killed in ClassifyNewTrack().
+/// The number of skipped tracks is reported by XRayRunAction.
+///
+/// The mode is selected with the /xray/firstHit command.
+///
+/// When the culling is active, the neutral tracks starting outside the
+/// target whose straight line misses both the detector and the target
+/// bounding boxes are killed in ClassifyNewTrack(): they can reach the
+/// detector only by scattering in air, which is neglected. 
+/// The tracks starting in the target can be culled too (ignoring their
+/// further interactions in the target). The photons leaving the target
+/// (primaries and fluorescence alike) are tested again on their first step
+/// out of it by the XRayCulling process of the gamma, configured in 
+/// BeginOfRun(). The fraction of culled tracks, over both tests, is
+/// reported by XRayRunAction.
+///
+/// The bounding boxes are computed once per run, in BeginOfRun() called
+/// by XRayRunAction.
+///
+/// The culling is configured with the /xray/cull/ commands.
+///
+/// When the next-event estimator is active, each fluorescence photon 
+/// created by the photo-electric effect in the target adds its probability
+/// to reach the detector (XRayNextEventEstimator) to the EDetFluoNEE tally
+/// of XRayEventAction. The photon can then be either tracked as usual or 
+/// killed, so that the analog scoring is replaced by the estimator.
+/// As the estimator scores all the photons, its analog counterpart is 
+/// EDetFluo in the "all" scoring mode; a warning is given in the "first"
+/// one.
+///
+/// The estimator is configured with the /xray/nee/ commands.
+///
+/// The scoring mode of the detector tallies of XRayEventAction is selected
+/// with the /xray/scoring command: "first" scores the first photon of each
+/// primary (the default), "all" scores all the photons with their weights,
+/// in analog runs as well. The "first-hit" mode is disabled in the "all" 
+/// mode.
+///
+/// When the fluorescence biasing is set in XRayPhysicsList (/phys/fluoBiasing),
+/// BeginOfRun() configures the XRayFluoBiasing process of the gamma, which
+/// emits the fluorescence photons from the target again toward the detector;
+/// these photons are not culled. As the biased photons are weighted, the 
+/// first one of each primary alone would give a biased tally: the biasing 
+/// requires the "all" scoring mode, and the run is refused in the "first"
+/// one. The same holds with the forced collision in the target
+/// (/phys/forceCollision), which splits the gamma into a weighted uncollided
+/// and collided pair.
+
+class XRayStackingAction : public G4UserStackingAction
+{
+  public:
+    XRayStackingAction(const XRayDetectorConstruction* detConstruction,
+                       XRayRunAction* runAction,
+                       XRayEventAction* eventAction);
+    virtual ~XRayStackingAction();
+
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+    virtual void PrepareNewEvent();
+
+    void BeginOfRun();
+    void DiscardEvent();
+
+    // set methods
+    void SetFirstHitMode(G4bool value);
+    void SetScoringMode(const G4String& value);
+    void SetCulling(G4bool value);
+    void SetCullingMargin(G4double value);
+    void SetCullingInTarget(G4bool value);
+    void SetNextEvent(G4bool value);
+    void SetNextEventKillAnalog(G4bool value);
+
+    // get methods
+    G4bool GetFirstHitMode() const;
+    G4bool GetAdditiveScoring() const;
+
+  private:
+    G4bool IsCulled(const G4Track* track) const;
+    G4bool IsTargetFluorescence(const G4Track* track) const;
+
+    const XRayDetectorConstruction* fDetConstruction;
+    XRayRunAction*          fRunAction;
+    XRayEventAction*        fEventAction;
+    XRayNextEventEstimator* fEstimator;
+    XRayStackingMessenger*  fMessenger;
+
+    G4bool  fFirstHitMode;   // option to terminate the event after the first hits
+    G4bool  fEventDiscarded; // the current event has been terminated
+
+    G4bool    fCulling;         // option to cull the tracks missing the detector
+    G4double  fCullingMargin;   // margin added to the detector bounding box
+    G4bool    fCullingInTarget; // option to cull the tracks starting in the target
+    XRayBoundingBox fTargetBox;
+    XRayBoundingBox fDetectorBox;
+
+    G4bool  fNextEvent;          // option to score the next-event estimator
+    G4bool  fNextEventKillAnalog; // option to kill the estimated photons
+    G4int   fPhotSubType;        // sub-type of the photo-electric process
+
+    G4double  fFluoBiasing;  // probability of the emission toward the detector
+    G4bool    fAdditiveScoring; // all the photons are scored (/xray/scoring all)
+};
+
+// inline functions
+
+inline void XRayStackingAction::SetFirstHitMode(G4bool value) {
+  fFirstHitMode = value;
+}
+
+inline void XRayStackingAction::SetCulling(G4bool value) {
+  fCulling = value;
+}
+
+inline void XRayStackingAction::SetCullingMargin(G4double value) {
+  fCullingMargin = value;
+}
+
+inline void XRayStackingAction::SetCullingInTarget(G4bool value) {
+  fCullingInTarget = value;
+}
+
+inline void XRayStackingAction::SetNextEvent(G4bool value) {
+  fNextEvent = value;
+}
+
+inline void XRayStackingAction::SetNextEventKillAnalog(G4bool value) {
+  fNextEventKillAnalog = value;
+}
+
+inline void XRayStackingAction::SetScoringMode(const G4String& value) {
+  fAdditiveScoring = ( value == "all" );
+}
+
+inline G4bool XRayStackingAction::GetFirstHitMode() const {
+  return fFirstHitMode && ! fAdditiveScoring;
+}
+
+inline G4bool XRayStackingAction::GetAdditiveScoring() const {
+  return fAdditiveScoring;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
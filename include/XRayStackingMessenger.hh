@@ -0,0 +1,71 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayStackingMessenger.hh
+/// \brief Definition of the XRayStackingMessenger class
+
+#ifndef XRayStackingMessenger_h
+#define XRayStackingMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class XRayStackingAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class XRayStackingMessenger: public G4UImessenger
+{
+  public:
+    XRayStackingMessenger(XRayStackingAction*);
+    virtual ~XRayStackingMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+    XRayStackingAction*  fStackingAction;
+
+    G4UIdirectory*       fXRayDir;
+    G4UIcmdWithABool*    fFirstHitCmd;
+    G4UIcmdWithAString*  fScoringCmd;
+
+    G4UIdirectory*              fCullDir;
+    G4UIcmdWithABool*           fCullCmd;
+    G4UIcmdWithADoubleAndUnit*  fCullMarginCmd;
+    G4UIcmdWithABool*           fCullInTargetCmd;
+
+    G4UIdirectory*       fNeeDir;
+    G4UIcmdWithABool*    fNeeCmd;
+    G4UIcmdWithABool*    fNeeKillCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -31,15 +31,21 @@
 #define XRaySteppingAction_h 1
 
 #include "G4UserSteppingAction.hh"
+#include "globals.hh"
 
 class XRayDetectorConstruction;
 class XRayEventAction;
+class G4VPhysicalVolume;
 
 /// Stepping action class.
 ///
-/// In UserSteppingAction() there are collected the energy deposit and track 
-/// lengths of charged particles in Absober and Gap layers and
-/// updated in XRayEventAction.
+/// In UserSteppingAction() the photons entering the detector are scored
+/// in XRayEventAction via the XRayDefaultScorers set.
+///
+/// The detector physical volume and the sub-type of the photo-electric
+/// process are resolved once per run in BeginOfRun(), so that the steps
+/// outside the detector cost a single pointer comparison.
+/// The number of steps is counted for the throughput report of XRayRunAction.
 
 class XRaySteppingAction : public G4UserSteppingAction
 {
@@ -49,12 +55,24 @@ public:
   virtual ~XRaySteppingAction();
 
   virtual void UserSteppingAction(const G4Step* step);
+
+  void   BeginOfRun();
+  G4long GetNofSteps() const;
     
 private:
   const XRayDetectorConstruction* fDetConstruction;
   XRayEventAction*  fEventAction;  
+  const G4VPhysicalVolume* fDetectorPV; // cached detector physical volume
+  G4int   fPhotSubType; // sub-type of the photo-electric process
+  G4long  fNofSteps;    // number of steps in the current run
 };
 
+// inline functions
+
+inline G4long XRaySteppingAction::GetNofSteps() const {
+  return fNofSteps;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #endif
@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRaySweep.hh
+/// \brief Definition of the XRaySweep class
+
+#ifndef XRaySweep_h
+#define XRaySweep_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class XRaySweepMessenger;
+
+/// Parameter sweep in a single process.
+///
+/// Each axis of the sweep is a UI command with a list of values, e.g. 
+/// /gun/energy, /xray/det/targetThickness or /xray/det/targetMaterial. 
+/// BeamOn() runs the given number of events at each point of the grid of
+/// all the axes (the last axis running fastest), applying at each point
+/// only the commands whose value changed. The initialization and the
+/// physics tables are thus kept across the points: a new thickness only
+/// closes the geometry again, a new material rebuilds the physics tables,
+/// a new beam energy rebuilds nothing.
+///
+/// The outputs of each point have the suffix "_sweep<k>" (GetLabel()),
+/// and the values and the times of the points are written in 
+/// XRay_sweep.csv. The setup of each point (a run of no event, which
+/// makes the rebuilds) is timed apart from its run: the initialization
+/// time saved is estimated against one process per point, each making
+/// the initialization and the setup of the first point. It is the most
+/// accurate when the sweep makes the initialization and the first run 
+/// of the process.
+///
+/// The sweep is configured with the /xray/sweep/ commands.
+
+class XRaySweep
+{
+  public:
+    XRaySweep();
+    ~XRaySweep();
+
+    void AddAxis(const G4String& command, const G4String& values);
+    void Clear();
+    void BeamOn(G4int nofEvents);
+
+    // suffix of the outputs of the current point, empty out of a sweep
+    static const G4String& GetLabel();
+
+  private:
+    struct Axis
+    {
+      G4String fCommand;
+      std::vector<G4String> fValues;
+    };
+
+    XRaySweepMessenger* fMessenger;
+    std::vector<Axis>   fAxes;
+
+    static G4String fLabel;
+};
+
+// inline functions
+
+inline const G4String& XRaySweep::GetLabel() {
+  return fLabel;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
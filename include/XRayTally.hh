@@ -0,0 +1,105 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayTally.hh
+/// \brief Definition of the XRayTally class
+
+#ifndef XRayTally_h
+#define XRayTally_h 1
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Weighted tally with batch-means statistical errors.
+///
+/// The weighted fills of a one-dimensional tally are summed per bin in 
+/// fNofBatches batches, the event with ID i going to the batch i % fNofBatches,
+/// so that the batches do not depend on the number of threads
+/// (at least 2 batches are used).
+/// The tally is an accumulable: the worker tallies are merged into the 
+/// master one by G4AccumulableManager.
+///
+/// ComputeStatistics() returns the mean per event of a bin (or of the whole
+/// tally) and its relative error, estimated from the dispersion of the 
+/// batch means. The figure of merit of a run lasting T is 1/(R^2 T).
+
+class XRayTally : public G4VAccumulable
+{
+  public:
+    XRayTally(const G4String& name, G4int nofBins, G4double min, G4double max,
+              G4int nofBatches = 20);
+    virtual ~XRayTally();
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    void Fill(G4int eventID, G4double value, G4double weight = 1.);
+
+    // bin = -1 for the whole tally
+    void ComputeStatistics(G4int bin, G4int nofEvents, 
+                           G4double& mean, G4double& relError) const;
+
+    // flat copy of the sums, to be summed across processes
+    std::size_t GetDataSize() const;
+    void CopyTo(G4double* data) const;
+    void Add(const G4double* data);
+
+    G4int    GetNofBins() const;
+    G4int    GetNofBatches() const;
+    G4double GetBinLowEdge(G4int bin) const;
+
+  private:
+    G4int    fNofBins;
+    G4double fMin;
+    G4double fMax;
+    G4double fInvBinWidth;
+    G4int    fNofBatches;
+    std::vector<G4double> fSums; // weighted sums, [batch*fNofBins + bin]
+};
+
+// inline functions
+
+inline std::size_t XRayTally::GetDataSize() const {
+  return fSums.size();
+}
+
+inline G4int XRayTally::GetNofBins() const {
+  return fNofBins;
+}
+
+inline G4int XRayTally::GetNofBatches() const {
+  return fNofBatches;
+}
+
+inline G4double XRayTally::GetBinLowEdge(G4int bin) const {
+  return fMin + bin/fInvBinWidth;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
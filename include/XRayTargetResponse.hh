@@ -0,0 +1,164 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayTargetResponse.hh
+/// \brief Definition of the XRayTargetResponse class
+
+#ifndef XRayTargetResponse_h
+#define XRayTargetResponse_h 1
+
+#include "G4VAccumulable.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/// Response of the target foil to the photons: mean number of photons
+/// leaving the foil per incident photon, by incident energy and angle, 
+/// and by outgoing energy and direction.
+///
+/// The foil is the target box, its normal the local z axis. An incident 
+/// photon is binned by its energy (logarithmic bins over the range of 
+/// /phys/targetResponseRange) and by the cosine of its angle to the 
+/// normal; the outgoing photons by the cosine of their angle to the 
+/// normal, oriented toward the exit side (< 0 back to the entrance side,
+/// > 0 through the foil), and by their azimuth relative to the incident
+/// one (Frame). Their energy is binned:
+/// - relative to the incident one for the scattered photons, the elastic
+///   ones (Rayleigh) having a bin of their own, so that the table holds
+///   for any energy within an incident bin
+/// - absolute, by 10 eV, for the fluorescence photons, i.e. the photons
+///   created by the photo-electric effect, as in the scoring
+/// The primaries crossing the foil without interaction are counted apart,
+/// to keep their energy and direction.
+///
+/// The table is filled by XRayTargetResponseSD during full simulation
+/// runs (/phys/targetResponse build): each thread fills its own instance,
+/// merged by the accumulable manager, and the master writes it at the end
+/// of run with Write(). The file is binary and compact: only the non-empty
+/// cells are written, as (index, yield) pairs of 32-bit values. Its header
+/// records the target material and thickness given by SetTarget().
+///
+/// Read() loads a table for XRayTargetResponseModel (/phys/targetResponse
+/// use), which samples the outgoing photons of an incident one with 
+/// GetYield() and Sample(); IsBuiltFor() tells whether the table holds for
+/// the current target.
+
+class XRayTargetResponse : public G4VAccumulable
+{
+  public:
+    XRayTargetResponse(const G4String& name);
+    virtual ~XRayTargetResponse();
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    /// Frame of an incident photon, in the local frame of the foil
+    class Frame 
+    {
+      public:
+        Frame(const G4ThreeVector& incidentDirection);
+
+        G4double GetCosTheta() const { return fSide*fDirection.z(); }
+        G4double GetSide() const { return fSide; }
+
+        void ToAngles(const G4ThreeVector& direction, 
+                      G4double& cosTheta, G4double& phi) const;
+        G4ThreeVector ToDirection(G4double cosTheta, G4double phi) const;
+
+      private:
+        G4ThreeVector fDirection;
+        G4double fSide;    // +1 entering by the -z face, -1 by the +z one
+        G4double fAzimuth; // of the incident direction, on the exit side
+    };
+
+    /// Outgoing photon sampled by Sample()
+    struct Photon
+    {
+      G4bool   fUncollided;
+      G4bool   fFluo;
+      G4double fEnergy;
+      G4double fCosTheta;
+      G4double fPhi;
+    };
+
+    // filling (build mode); a new range books and resets the table
+    void SetEnergyRange(G4double emin, G4double emax);
+
+    G4int FindBin(G4double energy, G4double cosTheta) const;
+    void  AddIncident(G4int bin, G4double weight);
+    void  AddUncollided(G4int bin, G4double weight);
+    void  AddOutgoing(G4int bin, G4double incidentEnergy, G4double energy,
+                      G4double cosTheta, G4double phi, G4bool fluo, 
+                      G4double weight);
+    G4double GetNofIncident() const;
+    void SetTarget(const G4String& material, G4double thickness);
+
+    // target of the table
+    const G4String& GetMaterial() const { return fMaterial; }
+    G4double GetThickness() const { return fThickness; }
+    G4bool IsBuiltFor(const G4String& material, G4double thickness) const;
+
+    G4bool Write(const G4String& fileName) const;
+    G4bool Read(const G4String& fileName);
+
+    // sampling, after Read()
+    G4double GetYield(G4int bin) const;
+    Photon   Sample(G4int bin, G4double incidentEnergy) const;
+
+  private:
+    struct Bin
+    {
+      G4double fIncident;   // sum of the weights of the incident photons
+      G4double fUncollided; // the same for the uncollided ones
+      std::map<std::uint32_t, G4double> fCells; // sums of the weights
+      // sampling tables, cumulative yields of the cells
+      std::vector<std::uint32_t> fIndices;
+      std::vector<G4double> fCumulative;
+    };
+
+    void Book();
+    G4int GetNofOutgoingEnergies() const;
+
+    G4double fEmin;
+    G4double fEmax;
+    G4int    fNofEnergies;      // incident, logarithmic
+    G4int    fNofAngles;        // incident, cosine to the normal
+    G4int    fNofRatios;        // outgoing scattered, E/E0
+    G4int    fNofFluoEnergies;  // outgoing fluorescence, 10 eV each
+    G4int    fNofCosines;       // outgoing, cosine to the normal
+    G4int    fNofAzimuths;      // outgoing, relative to the incident
+    std::vector<Bin> fBins;     // by incident energy, then angle
+    G4String fMaterial;         // target the table is built for
+    G4double fThickness;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
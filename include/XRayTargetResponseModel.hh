@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayTargetResponseModel.hh
+/// \brief Definition of the XRayTargetResponseModel class
+
+#ifndef XRayTargetResponseModel_h
+#define XRayTargetResponseModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+
+class XRayTargetResponse;
+
+/// Surrogate of the target foil (/phys/targetResponse use).
+///
+/// The model is attached to the "Target" region. A photon entering the
+/// foil by one of its faces, within the range of the XRayTargetResponse
+/// table, is killed and replaced by photons sampled from the table of its
+/// energy and angle bin, their number having the yield of the bin as mean.
+/// They start on the face of their exit side, at the entrance point and
+/// just out of the foil, with the weight of the incident photon; the 
+/// uncollided ones keep the incident energy and direction and start at 
+/// their exit point. The electrons and the cascades of the foil are thus
+/// not transported.
+///
+/// The fluorescence photons get the creator model ID of GetFluoModelID(),
+/// by which the scoring tells them from the scattered ones (their creator
+/// process is the fast simulation one). The ID is registered once, on the
+/// master, by XRayPhysicsList::ConstructProcess(), which sets it with
+/// SetFluoModelID() before the workers start.
+
+class XRayTargetResponseModel : public G4VFastSimulationModel
+{
+  public:
+    XRayTargetResponseModel(const G4String& name, G4Region* envelope,
+                            const XRayTargetResponse* response);
+    virtual ~XRayTargetResponseModel();
+
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+    static void  SetFluoModelID(G4int id);
+    static G4int GetFluoModelID();
+
+  private:
+    static G4int fFluoModelID;
+
+    const XRayTargetResponse* fResponse;
+
+    // computed by ModelTrigger() for DoIt()
+    G4int    fBin;
+    G4double fHalfThickness;
+};
+
+// inline functions
+
+inline void XRayTargetResponseModel::SetFluoModelID(G4int id) {
+  fFluoModelID = id;
+}
+
+inline G4int XRayTargetResponseModel::GetFluoModelID() {
+  return fFluoModelID;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayTargetResponseSD.hh
+/// \brief Definition of the XRayTargetResponseSD class
+
+#ifndef XRayTargetResponseSD_h
+#define XRayTargetResponseSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+class XRayEventAction;
+class XRayTargetResponse;
+class G4Step;
+class G4HCofThisEvent;
+
+/// Target sensitive detector class, which fills the XRayTargetResponse 
+/// table of the run (/phys/targetResponse build).
+///
+/// In ProcessHits(), the first entrance of each primary photon in the
+/// target is an incident photon, and each photon leaving the target 
+/// afterwards is an outgoing photon of that primary (XRayEventAction
+/// gives the primary of a track): it is uncollided if it is the primary
+/// with its incident energy and direction, a fluorescence photon if it
+/// was created by the photo-electric effect.
+///
+/// The table is the "TargetResponse" accumulable of XRayRunAction, which
+/// the master writes at the end of run. The first-hit mode of 
+/// XRayStackingAction, which terminates the events early, must not be
+/// used while the table is built.
+
+class XRayTargetResponseSD : public G4VSensitiveDetector
+{
+  public:
+    XRayTargetResponseSD(const G4String& name);
+    virtual ~XRayTargetResponseSD();
+  
+    // methods from base class
+    virtual void   Initialize(G4HCofThisEvent* hitCollection);
+    virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
+
+  private:
+    struct Incident
+    {
+      G4int         fBin;       // of the table, -1 if none or out of it
+      G4int         fTrackID;
+      G4double      fEnergy;
+      G4ThreeVector fDirection; // in the local frame of the target
+    };
+
+    XRayEventAction*    fEventAction;
+    XRayTargetResponse* fResponse;
+    G4int   fPhotSubType; // sub-type of the photo-electric process
+    std::vector<Incident> fIncidents; // per primary of the event
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayThreadStatistics.hh
+/// \brief Definition of the XRayThreadStatistics class
+
+#ifndef XRayThreadStatistics_h
+#define XRayThreadStatistics_h 1
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Per-thread statistics of a run: number of events, real time of the
+/// event loop and logical CPU, the latter read at the end of the run.
+///
+/// Each worker fills its own entry, by thread ID, and the accumulable 
+/// manager merges them into the master one. Print() gives the throughput
+/// of each thread relative to the mean one, so that the stragglers (slow
+/// or shared cores, remote memory) can be spotted.
+
+class XRayThreadStatistics : public G4VAccumulable
+{
+  public:
+    XRayThreadStatistics(const G4String& name);
+    virtual ~XRayThreadStatistics();
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    void Fill(G4int thread, G4long nofEvents, G4double realTime, G4int cpu);
+    void Print() const;
+
+    G4int GetNofThreads() const;
+
+  private:
+    struct Entry {
+      G4long   fNofEvents;
+      G4double fRealTime;
+      G4int    fCpu;
+    };
+
+    std::vector<Entry> fEntries; // by thread ID
+};
+
+// inline functions
+
+inline G4int XRayThreadStatistics::GetNofThreads() const {
+  G4int nofThreads = 0;
+  for ( const auto& entry : fEntries ) {
+    if ( entry.fRealTime > 0. ) ++nofThreads;
+  }
+  return nofThreads;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayTopology.hh
+/// \brief Definition of the XRayTopology class
+
+#ifndef XRayTopology_h
+#define XRayTopology_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Processor topology of the node, read from the Linux sysfs:
+/// the online logical CPUs, with their package (socket), physical core
+/// and NUMA node. It is empty on other systems.
+///
+/// GetPlacement() returns the logical CPU of each worker thread, 
+/// one thread per physical core before the hyperthread siblings are used:
+/// - compact: the cores of the first NUMA node, then of the next ones
+/// - scatter: the NUMA nodes in turn, so that the threads (and their
+///   memory bandwidth) are spread over the sockets
+/// The threads beyond the number of logical CPUs wrap around.
+
+class XRayTopology
+{
+  public:
+    XRayTopology();
+    ~XRayTopology();
+
+    std::vector<G4int> GetPlacement(const G4String& policy, 
+                                    G4int nofThreads) const;
+
+    G4bool IsEmpty() const;
+    G4int  GetNofCpus() const;
+    G4int  GetNofCores() const;
+    G4int  GetNofNodes() const;
+    G4int  GetNode(G4int cpu) const;
+
+    static G4bool PinCurrentThread(G4int cpu);
+    static G4int  GetCurrentCpu();
+
+  private:
+    struct Cpu {
+      G4int fCpu;
+      G4int fPackage;
+      G4int fCore;
+      G4int fNode;
+      G4int fSibling; // rank among the hyperthreads of the core
+    };
+
+    static std::vector<G4int> ReadList(const G4String& fileName);
+    static G4int ReadValue(const G4String& fileName, G4int defaultValue);
+
+    std::vector<Cpu> fCpus;
+    G4int fNofCores;
+    G4int fNofNodes;
+};
+
+// inline functions
+
+inline G4bool XRayTopology::IsEmpty() const {
+  return fCpus.empty();
+}
+
+inline G4int XRayTopology::GetNofCpus() const {
+  return fCpus.size();
+}
+
+inline G4int XRayTopology::GetNofCores() const {
+  return fNofCores;
+}
+
+inline G4int XRayTopology::GetNofNodes() const {
+  return fNofNodes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
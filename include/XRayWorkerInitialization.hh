@@ -0,0 +1,63 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayWorkerInitialization.hh
+/// \brief Definition of the XRayWorkerInitialization class
+
+#ifndef XRayWorkerInitialization_h
+#define XRayWorkerInitialization_h 1
+
+#include "G4UserWorkerInitialization.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Worker initialization class, which pins each worker thread to its
+/// logical CPU of a placement computed by XRayTopology.
+///
+/// WorkerInitialize() is called on the new thread before its physics list,
+/// geometry and user actions are built: as Linux allocates a page on the 
+/// NUMA node of the thread which first touches it, all the thread-local 
+/// data (physics tables, histograms, tallies) are then placed on the node 
+/// of the core running the thread.
+
+class XRayWorkerInitialization : public G4UserWorkerInitialization
+{
+  public:
+    XRayWorkerInitialization(const std::vector<G4int>& placement,
+                             const std::vector<G4int>& nodes);
+    virtual ~XRayWorkerInitialization();
+
+    virtual void WorkerInitialize() const;
+
+  private:
+    std::vector<G4int> fPlacement; // logical CPU of each thread
+    std::vector<G4int> fNodes;     // its NUMA node
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
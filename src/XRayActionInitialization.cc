@@ -32,6 +32,7 @@
 #include "XRayRunAction.hh"
 #include "XRayEventAction.hh"
 #include "XRaySteppingAction.hh"
+#include "XRayStackingAction.hh"
 #include "XRayDetectorConstruction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -58,11 +59,25 @@ void XRayActionInitialization::BuildForMaster() const
 
 void XRayActionInitialization::Build() const
 {
-  SetUserAction(new XRayPrimaryGeneratorAction);
-  SetUserAction(new XRayRunAction);
-  auto eventAction = new XRayEventAction;
+  auto primaryGenerator = new XRayPrimaryGeneratorAction;
+  SetUserAction(primaryGenerator);
+  auto runAction = new XRayRunAction;
+  SetUserAction(runAction);
+  runAction->SetPrimaryGeneratorAction(primaryGenerator);
+  auto eventAction = new XRayEventAction(runAction);
   SetUserAction(eventAction);
-  SetUserAction(new XRaySteppingAction(fDetConstruction,eventAction));
+  auto stackingAction 
+    = new XRayStackingAction(fDetConstruction,runAction,eventAction);
+  SetUserAction(stackingAction);
+  runAction->SetStackingAction(stackingAction);
+
+  // The stepping action is only needed when it is used for scoring,
+  // otherwise the detector is scored by its sensitive detector
+  if ( fDetConstruction->GetSteppingScoring() ) {
+    auto steppingAction = new XRaySteppingAction(fDetConstruction,eventAction);
+    SetUserAction(steppingAction);
+    runAction->SetSteppingAction(steppingAction);
+  }
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
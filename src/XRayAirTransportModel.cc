@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayAirTransportModel.cc
+/// \brief Implementation of the XRayAirTransportModel class
+
+#include "XRayAirTransportModel.hh"
+#include "XRayAttenuation.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Material.hh"
+#include "G4Gamma.hh"
+#include "G4EmParameters.hh"
+#include "G4PhysicsLogVector.hh"
+#include "G4GeometryTolerance.hh"
+#include "Randomize.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayAirTransportModel::XRayAirTransportModel(const G4String& name, 
+                                             G4Region* envelope,
+                                             G4bool roulette)
+ : G4VFastSimulationModel(name, envelope),
+   fRoulette(roulette),
+   fNavigator(nullptr),
+   fCalculator(nullptr),
+   fDistance(0.),
+   fLeavingWorld(false)
+{
+  fNavigator = new G4Navigator();
+  fCalculator = new XRayAttenuation();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayAirTransportModel::~XRayAirTransportModel()
+{
+  delete fNavigator;
+  delete fCalculator;
+  for ( auto& attenuation : fAttenuations ) delete attenuation.second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayAirTransportModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Gamma::Gamma();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayAirTransportModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  // The world is the envelope: the local frame is the global one
+  auto position = fastTrack.GetPrimaryTrackLocalPosition();
+  auto direction = fastTrack.GetPrimaryTrackLocalDirection();
+
+  // The navigator of the model follows the geometry of the tracking one
+  auto world = G4TransportationManager::GetTransportationManager()
+                 ->GetNavigatorForTracking()->GetWorldVolume();
+  if ( fNavigator->GetWorldVolume() != world ) fNavigator->SetWorldVolume(world);
+
+  // Distance to the next boundary, of a daughter or of the world
+  G4double safety;
+  fNavigator->LocateGlobalPointAndSetup(position, &direction, false, false);
+  fDistance = fNavigator->ComputeStep(position, direction, kInfinity, safety);
+  auto distanceOut 
+    = fastTrack.GetEnvelopeSolid()->DistanceToOut(position, direction);
+  fLeavingWorld = ( fDistance >= distanceOut );
+  if ( fLeavingWorld ) fDistance = distanceOut;
+
+  if ( fLeavingWorld ) return true;
+
+  // The photon is stopped short of the daughter by the surface tolerance:
+  // the transportation makes the crossing, so that the step into the 
+  // volume starts on a geometry boundary, as the sensitive detectors 
+  // expect (the fast step would leave the status fExclusivelyForcedProc)
+  auto tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  if ( fDistance == kInfinity || fDistance <= 2.*tolerance ) return false;
+  fDistance -= tolerance;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayAirTransportModel::DoIt(const G4FastTrack& fastTrack, 
+                                 G4FastStep& fastStep)
+{
+  // Nothing more to score once out of the world
+  if ( fLeavingWorld ) {
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength(fDistance);
+    return;
+  }
+
+  auto track = fastTrack.GetPrimaryTrack();
+  auto material = fastTrack.GetEnvelopeLogicalVolume()->GetMaterial();
+  auto transmission 
+    = std::exp(-GetAttenuation(material, track->GetKineticEnergy())*fDistance);
+
+  if ( fRoulette ) {
+    if ( G4UniformRand() >= transmission ) {
+      fastStep.KillPrimaryTrack();
+      fastStep.ProposePrimaryTrackPathLength(fDistance);
+      return;
+    }
+  }
+  else {
+    fastStep.ProposePrimaryTrackFinalEventBiasingWeight(
+      track->GetWeight()*transmission);
+  }
+
+  // Straight to the boundary (short of it for a daughter), at the speed
+  // of light
+  fastStep.ProposePrimaryTrackFinalPosition(
+    fastTrack.GetPrimaryTrackLocalPosition() 
+    + fDistance*fastTrack.GetPrimaryTrackLocalDirection());
+  fastStep.ProposePrimaryTrackFinalTime(
+    track->GetGlobalTime() + fDistance/c_light);
+  fastStep.ProposePrimaryTrackPathLength(fDistance);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayAirTransportModel::GetAttenuation(const G4Material* material,
+                                               G4double energy)
+{
+  auto it = fAttenuations.find(material);
+  if ( it == fAttenuations.end() ) {
+    // 20 points per decade over the EM tables range
+    auto emParameters = G4EmParameters::Instance();
+    auto emin = emParameters->MinKinEnergy();
+    auto emax = emParameters->MaxKinEnergy();
+    auto nofBins = std::max(1, G4int(20*std::log10(emax/emin)));
+    auto table = new G4PhysicsLogVector(emin, emax, nofBins);
+
+    for ( size_t i=0; i<table->GetVectorLength(); ++i ) {
+      table->PutValue(i, fCalculator->Compute(material, table->Energy(i)));
+    }
+    it = fAttenuations.insert(std::make_pair(material, table)).first;
+  }
+  return it->second->Value(energy);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,109 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayCulling.cc
+/// \brief Implementation of the XRayCulling class
+
+#include "XRayCulling.hh"
+#include "XRayRunAction.hh"
+
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4Gamma.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayCulling::XRayCulling(const G4String& processName)
+ : G4VDiscreteProcess(processName),
+   fActive(false),
+   fTargetPV(nullptr),
+   fRunAction(nullptr),
+   fTrackID(0),
+   fInTarget(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayCulling::~XRayCulling()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayCulling::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return ( &particle == G4Gamma::Gamma() );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayCulling::Configure(G4bool active, const G4VPhysicalVolume* targetPV,
+                            const XRayBoundingBox& detectorBox,
+                            XRayRunAction* runAction)
+{
+  fActive = active;
+  fTargetPV = targetPV;
+  fDetectorBox = detectorBox;
+  fRunAction = runAction;
+  fTrackID = 0;
+  fInTarget = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayCulling::PostStepGetPhysicalInteractionLength(
+                        const G4Track& track, G4double, 
+                        G4ForceCondition* condition)
+{
+  *condition = NotForced;
+  if ( ! fActive ) return DBL_MAX;
+
+  // The track IDs start again at each event: the first step of a track 
+  // has no previous step
+  auto leftTarget = ( fInTarget && track.GetTrackID() == fTrackID 
+                      && track.GetCurrentStepNumber() > 1 );
+  fTrackID = track.GetTrackID();
+  fInTarget = ( track.GetVolume() == fTargetPV );
+  if ( ! leftTarget || fInTarget ) return DBL_MAX;
+
+  // First step out of the target: the straight line must hit the detector
+  auto culled = ! fDetectorBox.IsHitBy(track.GetPosition(), 
+                                       track.GetMomentumDirection());
+  if ( fRunAction ) fRunAction->CountCullingTest(culled);
+
+  return culled ? 0. : DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* XRayCulling::PostStepDoIt(const G4Track& track, 
+                                             const G4Step&)
+{
+  aParticleChange.Initialize(track);
+  aParticleChange.ProposeTrackStatus(fStopAndKill);
+  return &aParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,6 +28,12 @@
 /// \brief Implementation of the XRayDetectorConstruction class
 
 #include "XRayDetectorConstruction.hh"
+#include "XRayDetectorMessenger.hh"
+#include "XRayDetectorSD.hh"
+#include "XRayPhysicsList.hh"
+#include "XRayAirTransportModel.hh"
+#include "XRayTargetResponseModel.hh"
+#include "XRayTargetResponseSD.hh"
 
 #include "G4Material.hh"
 #include "G4NistManager.hh"
@@ -42,7 +48,12 @@
 #include "G4GeometryManager.hh"
 #include "G4PhysicalVolumeStore.hh"
 #include "G4LogicalVolumeStore.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
 #include "G4SolidStore.hh"
+#include "G4SDManager.hh"
+#include "G4RunManager.hh"
+#include "G4BOptrForceCollision.hh"
 
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
@@ -59,16 +70,22 @@
 
 XRayDetectorConstruction::XRayDetectorConstruction()
  : G4VUserDetectorConstruction(),
+   fMessenger(nullptr),
    fTargetPV(nullptr),
    fDetectorPV(nullptr),
-   fCheckOverlaps(true)
+   fCheckOverlaps(true),
+   fSteppingScoring(false),
+   fTargetMaterial("G4_Ti"),
+   fTargetThickness(.001*mm)
 {
+  fMessenger = new XRayDetectorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 XRayDetectorConstruction::~XRayDetectorConstruction()
 { 
+  delete fMessenger;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -93,7 +110,7 @@ void XRayDetectorConstruction::DefineMaterials()
   nistManager->FindOrBuildMaterial("G4_AIR");
 
   // Add Target material
-  nistManager->FindOrBuildMaterial("G4_Ti");
+  nistManager->FindOrBuildMaterial(fTargetMaterial);
 
   // Add Detector material
   nistManager->FindOrBuildMaterial("G4_AIR");
@@ -121,7 +138,7 @@ G4VPhysicalVolume* XRayDetectorConstruction::DefineVolumes()
 {
   // Geometry parameters
   //G4int nofLayers = 10;
-  G4double targetThickness = .001*mm;
+  G4double targetThickness = fTargetThickness;
   G4double detectorThickness =  1.*nm;
   G4double targetSizeXY = 5.*cm;
   G4double detectorSizeXY = 2.*cm;
@@ -130,7 +147,7 @@ G4VPhysicalVolume* XRayDetectorConstruction::DefineVolumes()
   
   // Get materials
   auto defaultMaterial = G4Material::GetMaterial("G4_AIR");
-  auto targetMaterial = G4Material::GetMaterial("G4_Ti");
+  auto targetMaterial = G4Material::GetMaterial(fTargetMaterial);
   auto detectorMaterial = G4Material::GetMaterial("G4_AIR");
   
   if ( ! defaultMaterial || ! targetMaterial || ! detectorMaterial ) {
@@ -211,23 +228,118 @@ G4VPhysicalVolume* XRayDetectorConstruction::DefineVolumes()
                  false,            // no boolean operation
                  0,                // copy number
                  fCheckOverlaps);  // checking overlaps 
+
+  //
+  // Regions of the target and of the detector, with their own cuts and
+  // atomic deexcitation (XRayPhysicsList); the world is the default region
+  //
+  auto regionStore = G4RegionStore::GetInstance();
+  regionStore->FindOrCreateRegion("Target")->AddRootLogicalVolume(targetLV);
+  regionStore->FindOrCreateRegion("Detector")->AddRootLogicalVolume(detectorLV);
   
   return worldPV;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-/*
+
+void XRayDetectorConstruction::SetTargetMaterial(const G4String& name)
+{
+  auto material = G4NistManager::Instance()->FindOrBuildMaterial(name);
+  if ( ! material ) {
+    G4ExceptionDescription msg;
+    msg << "Material " << name << " not found, "
+        << "the target material is not changed.";
+    G4Exception("XRayDetectorConstruction::SetTargetMaterial()",
+      "MyCode0008", JustWarning, msg);
+    return;
+  }
+  fTargetMaterial = name;
+
+  // Before the construction, the material is used by DefineVolumes()
+  if ( ! fTargetPV ) return;
+
+  auto targetLV = fTargetPV->GetLogicalVolume();
+  if ( targetLV->GetMaterial() == material ) return;
+  targetLV->SetMaterial(material);
+
+  // A new material needs new couples and physics tables
+  G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayDetectorConstruction::SetTargetThickness(G4double value)
+{
+  if ( value == fTargetThickness ) return;
+  fTargetThickness = value;
+  if ( ! fTargetPV ) return;
+
+  // The solid is resized in place, the geometry is closed again
+  // (voxelisation) at the next run, the physics tables are kept
+  auto targetS = static_cast<G4Box*>(fTargetPV->GetLogicalVolume()->GetSolid());
+  targetS->SetZHalfLength(value/2);
+  G4RunManager::GetRunManager()->GeometryHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void XRayDetectorConstruction::ConstructSDandField()
 { 
+  // Forced collision of the gamma in the target, 
+  // if the physics list is prepared for biasing
+  auto physicsList = dynamic_cast<const XRayPhysicsList*>(
+    G4RunManager::GetRunManager()->GetUserPhysicsList());
+  if ( physicsList && physicsList->GetForceCollision() ) {
+    auto forceCollision 
+      = new G4BOptrForceCollision("gamma", "ForceCollisionInTarget");
+    forceCollision->AttachTo(fTargetPV->GetLogicalVolume());
+  }
+
+  // Fast transport of the gamma through the air of the world; the target
+  // and detector regions keep the full transport
+  if ( physicsList && physicsList->GetAirTransport() != "none" ) {
+    auto worldRegion = G4RegionStore::GetInstance()
+                         ->GetRegion("DefaultRegionForTheWorld", false);
+    auto airTransport 
+      = new XRayAirTransportModel("AirTransport", worldRegion,
+                                  physicsList->GetAirTransport() == "roulette");
+    G4AutoDelete::Register(airTransport);
+  }
+
+  // Target response: the table is filled by a sensitive detector on the
+  // target, or sampled instead of the full simulation of the target
+  if ( physicsList && physicsList->GetTargetResponseMode() == "build" ) {
+    auto responseSD = new XRayTargetResponseSD("TargetResponseSD");
+    G4SDManager::GetSDMpointer()->AddNewDetector(responseSD);
+    SetSensitiveDetector(fTargetPV->GetLogicalVolume(), responseSD);
+  }
+  if ( physicsList && physicsList->GetTargetResponse() ) {
+    auto targetRegion 
+      = G4RegionStore::GetInstance()->GetRegion("Target", false);
+    auto targetResponse
+      = new XRayTargetResponseModel("TargetResponse", targetRegion,
+                                    physicsList->GetTargetResponse());
+    G4AutoDelete::Register(targetResponse);
+  }
+
+  // Sensitive detector scoring the photons entering the detector,
+  // unless the stepping action scores the detector by itself
+  if ( ! fSteppingScoring ) {
+    auto detectorSD 
+      = new XRayDetectorSD("DetectorSD", "DetectorHitsCollection");
+    G4SDManager::GetSDMpointer()->AddNewDetector(detectorSD);
+    SetSensitiveDetector("Detector", detectorSD);
+  }
+
   // Create global magnetic field messenger.
   // Uniform magnetic field is then created automatically if
   // the field value is not zero.
-  G4ThreeVector fieldValue;
-  fMagFieldMessenger = new G4GlobalMagFieldMessenger(fieldValue);
-  fMagFieldMessenger->SetVerboseLevel(1);
+  //G4ThreeVector fieldValue;
+  //fMagFieldMessenger = new G4GlobalMagFieldMessenger(fieldValue);
+  //fMagFieldMessenger->SetVerboseLevel(1);
   
   // Register the field messenger for deleting
-  G4AutoDelete::Register(fMagFieldMessenger);
+  //G4AutoDelete::Register(fMagFieldMessenger);
 }
-*/
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
\ No newline at end of file
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
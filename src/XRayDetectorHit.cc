@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayDetectorHit.cc
+/// \brief Implementation of the XRayDetectorHit class
+
+#include "XRayDetectorHit.hh"
+
+#include "G4UnitsTable.hh"
+
+#include <iomanip>
+
+G4ThreadLocal G4Allocator<XRayDetectorHit>* XRayDetectorHitAllocator = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayDetectorHit::XRayDetectorHit()
+ : G4VHit(),
+   fTrackID(-1),
+   fEnergy(0.),
+   fWeight(1.),
+   fFromPhot(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayDetectorHit::~XRayDetectorHit() 
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayDetectorHit::XRayDetectorHit(const XRayDetectorHit& right)
+  : G4VHit()
+{
+  fTrackID  = right.fTrackID;
+  fEnergy   = right.fEnergy;
+  fWeight   = right.fWeight;
+  fFromPhot = right.fFromPhot;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const XRayDetectorHit& XRayDetectorHit::operator=(const XRayDetectorHit& right)
+{
+  fTrackID  = right.fTrackID;
+  fEnergy   = right.fEnergy;
+  fWeight   = right.fWeight;
+  fFromPhot = right.fFromPhot;
+
+  return *this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayDetectorHit::operator==(const XRayDetectorHit& right) const
+{
+  return ( this == &right ) ? true : false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayDetectorHit::Print()
+{
+  G4cout
+     << "  trackID: " << fTrackID
+     << " Energy: " 
+     << std::setw(7) << G4BestUnit(fEnergy,"Energy")
+     << " weight: " << fWeight
+     << ( fFromPhot ? " (phot)" : "" )
+     << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
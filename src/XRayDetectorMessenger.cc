@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayDetectorMessenger.cc
+/// \brief Implementation of the XRayDetectorMessenger class
+
+#include "XRayDetectorMessenger.hh"
+#include "XRayDetectorConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayDetectorMessenger::XRayDetectorMessenger(
+                         XRayDetectorConstruction* detConstruction)
+ : G4UImessenger(),
+   fDetConstruction(detConstruction)
+{
+  fDetDir = new G4UIdirectory("/xray/det/");
+  fDetDir->SetGuidance("Target of the XRay example");
+
+  // The geometry is shared by the threads and modified on the master only
+  fTargetMaterialCmd = new G4UIcmdWithAString("/xray/det/targetMaterial",this);
+  fTargetMaterialCmd->SetGuidance("Set the target material (NIST name).");
+  fTargetMaterialCmd->SetGuidance("The physics tables are rebuilt at the next run.");
+  fTargetMaterialCmd->SetParameterName("material",false);
+  fTargetMaterialCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fTargetMaterialCmd->SetToBeBroadcasted(false);
+
+  fTargetThicknessCmd 
+    = new G4UIcmdWithADoubleAndUnit("/xray/det/targetThickness",this);
+  fTargetThicknessCmd->SetGuidance("Set the target thickness.");
+  fTargetThicknessCmd->SetParameterName("thickness",false);
+  fTargetThicknessCmd->SetUnitCategory("Length");
+  fTargetThicknessCmd->SetRange("thickness>0.");
+  fTargetThicknessCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fTargetThicknessCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayDetectorMessenger::~XRayDetectorMessenger()
+{
+  delete fTargetMaterialCmd;
+  delete fTargetThicknessCmd;
+  delete fDetDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fTargetMaterialCmd ) 
+   { fDetConstruction->SetTargetMaterial(newValue); }
+
+  if ( command == fTargetThicknessCmd ) 
+   { fDetConstruction->SetTargetThickness(
+       fTargetThicknessCmd->GetNewDoubleValue(newValue)); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
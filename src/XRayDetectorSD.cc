@@ -0,0 +1,159 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayDetectorSD.cc
+/// \brief Implementation of the XRayDetectorSD class
+
+#include "XRayDetectorSD.hh"
+#include "XRayStackingAction.hh"
+#include "XRayEventAction.hh"
+#include "XRayTargetResponseModel.hh"
+
+#include "G4HCofThisEvent.hh"
+#include "G4Step.hh"
+#include "G4SDManager.hh"
+#include "G4EventManager.hh"
+#include "G4VProcess.hh"
+#include "G4ProcessTable.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4ios.hh"
+
+namespace {
+  const G4int kDet = 1;
+  const G4int kDetFluo = 2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayDetectorSD::XRayDetectorSD(
+                            const G4String& name, 
+                            const G4String& hitsCollectionName)
+ : G4VSensitiveDetector(name),
+   fHitsCollection(nullptr),
+   fStackingAction(nullptr),
+   fEventAction(nullptr),
+   fPhotSubType(-1),
+   fNofCompleted(0)
+{
+  collectionName.insert(hitsCollectionName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayDetectorSD::~XRayDetectorSD() 
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayDetectorSD::Initialize(G4HCofThisEvent* hce)
+{
+  // Resolve the photo-electric process once; the physics is not yet
+  // constructed when the sensitive detector is created
+  if ( fPhotSubType < 0 ) {
+    auto phot = G4ProcessTable::GetProcessTable()->FindProcess("phot", "gamma");
+    fPhotSubType = phot ? phot->GetProcessSubType() : G4int(fPhotoElectricEffect);
+  }
+
+  // The user actions are not yet set when the sensitive detector is created
+  auto eventManager = G4EventManager::GetEventManager();
+  if ( ! fStackingAction ) {
+    fStackingAction = dynamic_cast<XRayStackingAction*>(
+      eventManager->GetUserStackingAction());
+    fEventAction = dynamic_cast<XRayEventAction*>(
+      eventManager->GetUserEventAction());
+  }
+
+  // Called before the event action, the primaries are already generated
+  fFilled.assign(
+    XRayEventAction::CountPrimaries(eventManager->GetConstCurrentEvent()), 0);
+  fNofCompleted = 0;
+
+  // Create hits collection
+  fHitsCollection 
+    = new XRayDetectorHitsCollection(SensitiveDetectorName, collectionName[0]); 
+
+  // Add this collection in hce
+  auto hcID 
+    = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+  hce->AddHitsCollection( hcID, fHitsCollection ); 
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayDetectorSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{  
+  // Score only the particles entering the detector
+  auto preStepPoint = step->GetPreStepPoint();
+  if ( preStepPoint->GetStepStatus() != fGeomBoundary ) return false;
+
+  auto track = step->GetTrack();
+  auto creator = track->GetCreatorProcess();
+
+  auto fromPhot = ( creator && creator->GetProcessSubType() == fPhotSubType )
+    || track->GetCreatorModelID() == XRayTargetResponseModel::GetFluoModelID();
+
+  auto hit = new XRayDetectorHit();
+  hit->SetTrackID(track->GetTrackID());
+  hit->SetEnergy(preStepPoint->GetTotalEnergy());
+  hit->SetWeight(preStepPoint->GetWeight());
+  hit->SetFromPhot(fromPhot);
+  fHitsCollection->insert(hit);
+
+  // Terminate the event when its tallies are final (first-hit mode)
+  if ( ! fStackingAction || ! fStackingAction->GetFirstHitMode() ) return true;
+
+  auto primary 
+    = fEventAction ? fEventAction->GetPrimaryIndex(track->GetTrackID()) : 0;
+  if ( primary >= G4int(fFilled.size()) ) return true;
+  auto& filled = fFilled[primary];
+  if ( filled == (kDet | kDetFluo) ) return true;
+  filled |= kDet;
+  if ( fromPhot ) filled |= kDetFluo;
+  if ( filled == (kDet | kDetFluo) ) ++fNofCompleted;
+
+  if ( fNofCompleted == G4int(fFilled.size()) ) {
+    track->SetTrackStatus(fKillTrackAndSecondaries);
+    fStackingAction->DiscardEvent();
+  }
+      
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayDetectorSD::EndOfEvent(G4HCofThisEvent*)
+{
+  if ( verboseLevel>1 ) { 
+     auto nofHits = fHitsCollection->entries();
+     G4cout
+       << G4endl 
+       << "-------->Hits Collection: in this event there are " << nofHits 
+       << " hits in the detector: " << G4endl;
+     for ( std::size_t i=0; i<nofHits; ++i ) (*fHitsCollection)[i]->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,129 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayEmLitePhysics.cc
+/// \brief Implementation of the XRayEmLitePhysics class
+
+#include "XRayEmLitePhysics.hh"
+
+#include "G4PhysicsListHelper.hh"
+#include "G4LossTableManager.hh"
+#include "G4UAtomicDeexcitation.hh"
+
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+
+#include "G4PhotoElectricEffect.hh"
+#include "G4LivermorePhotoElectricModel.hh"
+#include "G4ComptonScattering.hh"
+#include "G4LivermoreComptonModel.hh"
+#include "G4RayleighScattering.hh"
+#include "G4GammaConversion.hh"
+
+#include "G4eMultipleScattering.hh"
+#include "G4eIonisation.hh"
+#include "G4LivermoreIonisationModel.hh"
+#include "G4UniversalFluctuation.hh"
+#include "G4eBremsstrahlung.hh"
+#include "G4eplusAnnihilation.hh"
+
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayEmLitePhysics::XRayEmLitePhysics(const G4String& name)
+ : G4VPhysicsConstructor(name)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayEmLitePhysics::~XRayEmLitePhysics()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayEmLitePhysics::ConstructParticle()
+{
+  G4Gamma::GammaDefinition();
+  G4Electron::ElectronDefinition();
+  G4Positron::PositronDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayEmLitePhysics::ConstructProcess()
+{
+  auto helper = G4PhysicsListHelper::GetPhysicsListHelper();
+
+  // gamma: the Livermore models, as G4EmLivermorePhysics
+  auto particle = G4Gamma::Gamma();
+
+  auto photoElectric = new G4PhotoElectricEffect();
+  photoElectric->SetEmModel(new G4LivermorePhotoElectricModel());
+  helper->RegisterProcess(photoElectric, particle);
+
+  auto compton = new G4ComptonScattering();
+  compton->SetEmModel(new G4LivermoreComptonModel());
+  helper->RegisterProcess(compton, particle);
+
+  // the Livermore model is the default one
+  helper->RegisterProcess(new G4RayleighScattering(), particle);
+  helper->RegisterProcess(new G4GammaConversion(), particle);
+
+  // e-: Livermore ionisation below 100 keV
+  particle = G4Electron::Electron();
+
+  helper->RegisterProcess(new G4eMultipleScattering(), particle);
+
+  auto eIoni = new G4eIonisation();
+  auto livermoreIoni = new G4LivermoreIonisationModel();
+  livermoreIoni->SetHighEnergyLimit(0.1*MeV);
+  eIoni->AddEmModel(0, livermoreIoni, new G4UniversalFluctuation());
+  helper->RegisterProcess(eIoni, particle);
+
+  helper->RegisterProcess(new G4eBremsstrahlung(), particle);
+
+  // e+
+  particle = G4Positron::Positron();
+
+  helper->RegisterProcess(new G4eMultipleScattering(), particle);
+  helper->RegisterProcess(new G4eIonisation(), particle);
+  helper->RegisterProcess(new G4eBremsstrahlung(), particle);
+  helper->RegisterProcess(new G4eplusAnnihilation(), particle);
+
+  // Atomic deexcitation: fluorescence, Auger and PIXE are switched on
+  // by XRayPhysicsList::ConstructProcess()
+  auto lossTableManager = G4LossTableManager::Instance();
+  if ( ! lossTableManager->AtomDeexcitation() ) {
+    lossTableManager->SetAtomDeexcitation(new G4UAtomicDeexcitation());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
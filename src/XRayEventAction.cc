@@ -30,21 +30,29 @@
 #include "XRayEventAction.hh"
 #include "XRayRunAction.hh"
 #include "XRayAnalysis.hh"
+#include "XRayDetectorHit.hh"
+#include "XRayScorers.hh"
 
 #include "G4RunManager.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SDManager.hh"
+#include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
 
 #include "Randomize.hh"
+#include <chrono>
 #include <iomanip>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-XRayEventAction::XRayEventAction()
+XRayEventAction::XRayEventAction(XRayRunAction* runAction)
  : G4UserEventAction(),
+  fRunAction(runAction),
   //fAnalysisManager(nullptr),
-  fEnergyDet(0.),
-  fEnergyDetFluo(0.)
+  fDetHCID(-1),
+  fNofPrimaries(0),
+  fAdditiveScoring(false)
   // fEnergyTar(0.),
   // fTrackLDet(0.),
   // fTrackLTar(0.)
@@ -57,11 +65,19 @@ XRayEventAction::~XRayEventAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void XRayEventAction::BeginOfEventAction(const G4Event* /*event*/)
+void XRayEventAction::BeginOfEventAction(const G4Event* event)
 {  
+  fStartTime = std::chrono::steady_clock::now();
+
   // initialisation per event
-  fEnergyDet     = 0.;
-  fEnergyDetFluo = 0.;
+  fNofPrimaries = CountPrimaries(event);
+  fEnergyDet.assign(fNofPrimaries, 0.);
+  fEnergyDetFluo.assign(fNofPrimaries, 0.);
+  fWeightDet.assign(fNofPrimaries, 1.);
+  fWeightDetFluo.assign(fNofPrimaries, 1.);
+  fDetFluoNEE.clear();
+  fDetAll.clear();
+  fDetFluoAll.clear();
   //fTrackLAbs = 0.;
   //fTrackLGap = 0.;
   //fAnalysisManager = G4AnalysisManager::Instance();
@@ -74,15 +90,49 @@ void XRayEventAction::EndOfEventAction(const G4Event* event)
   // Accumulate statistics
   //
 
-  // get analysis manager
-  
-  auto analysisManager = G4AnalysisManager::Instance();
+  // score the detector hits, if the sensitive detector is used
+  auto hce = event->GetHCofThisEvent();
+  if ( hce && fDetHCID == -1 ) {
+    fDetHCID 
+      = G4SDManager::GetSDMpointer()->GetCollectionID("DetectorHitsCollection");
+  }
+  if ( hce && fDetHCID >= 0 ) {
+    auto hitsCollection 
+      = static_cast<XRayDetectorHitsCollection*>(hce->GetHC(fDetHCID));
+    if ( hitsCollection ) {
+      for ( std::size_t i=0; i<hitsCollection->entries(); ++i ) {
+        auto hit = (*hitsCollection)[i];
+        XRayDetectorEntry entry;
+        entry.fPrimary = GetPrimaryIndex(hit->GetTrackID());
+        entry.fEnergy = hit->GetEnergy();
+        entry.fWeight = hit->GetWeight();
+        entry.fFromPhot = hit->IsFromPhot();
+        XRayDefaultScorers::Score(this, entry);
+      }
+    }
+  }
+
+  // fill histograms and tallies, with the weights of the photons,
+  // once per primary
+  auto eventID = event->GetEventID();
+  for ( G4int i=0; i<fNofPrimaries; ++i ) {
+    if(fEnergyDet[i] != 0.)
+      fRunAction->Fill(0, eventID, fEnergyDet[i], fWeightDet[i]);
+    if(fEnergyDetFluo[i] != 0.)
+      fRunAction->Fill(1, eventID, fEnergyDetFluo[i], fWeightDetFluo[i]);
+  }
+  for ( const auto& entry : fDetAll ) 
+    fRunAction->Fill(0, eventID, entry.first, entry.second);
+  for ( const auto& entry : fDetFluoAll ) 
+    fRunAction->Fill(1, eventID, entry.first, entry.second);
+  for ( const auto& estimate : fDetFluoNEE ) 
+    fRunAction->Fill(2, eventID, estimate.first, estimate.second);
+  fRunAction->AddPrimaries(fNofPrimaries);
 
-  // fill histograms
-  if(fEnergyDet != 0.)
-    analysisManager->FillH1(0, fEnergyDet);
-  if(fEnergyDetFluo != 0.)
-    analysisManager->FillH1(1, fEnergyDetFluo);
+  // time spent within the event, from BeginOfEventAction()
+  std::chrono::duration<G4double> elapsed 
+    = std::chrono::steady_clock::now() - fStartTime;
+  fRunAction->AddEventTime(elapsed.count());
   /*
   analysisManager->FillH1(2, fTrackLAbs);
   analysisManager->FillH1(3, fTrackLGap);
@@ -117,3 +167,14 @@ void XRayEventAction::EndOfEventAction(const G4Event* event)
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int XRayEventAction::CountPrimaries(const G4Event* event)
+{
+  G4int nofPrimaries = 0;
+  for ( G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i ) {
+    nofPrimaries += event->GetPrimaryVertex(i)->GetNumberOfParticle();
+  }
+  return nofPrimaries;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
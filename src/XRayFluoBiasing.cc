@@ -0,0 +1,141 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayFluoBiasing.cc
+/// \brief Implementation of the XRayFluoBiasing class
+
+#include "XRayFluoBiasing.hh"
+
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4Gamma.hh"
+#include "G4VProcess.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayFluoBiasing::XRayFluoBiasing(const G4String& processName)
+ : G4VDiscreteProcess(processName),
+   fFraction(0.),
+   fPhotSubType(-1)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayFluoBiasing::~XRayFluoBiasing()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayFluoBiasing::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return ( &particle == G4Gamma::Gamma() );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayFluoBiasing::Configure(G4double fraction, G4int photSubType,
+                                const G4VPhysicalVolume* targetPV,
+                                const G4VPhysicalVolume* detectorPV)
+{
+  fFraction = fraction;
+  fPhotSubType = photSubType;
+  if ( fFraction <= 0. ) return;
+
+  // The cone is built around the bare detector bounding box
+  fTargetBox.Set(targetPV);
+  fDetectorBox.Set(detectorPV);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayFluoBiasing::PostStepGetPhysicalInteractionLength(
+                            const G4Track& track, G4double, 
+                            G4ForceCondition* condition)
+{
+  *condition = NotForced;
+  if ( fFraction <= 0. || track.GetCurrentStepNumber() != 1 ) return DBL_MAX;
+
+  // A step of zero length at the emission of the fluorescence photons
+  // from the target
+  auto creator = track.GetCreatorProcess();
+  if ( ! creator || creator->GetProcessSubType() != fPhotSubType ) return DBL_MAX;
+  if ( ! fTargetBox.Contains(track.GetPosition()) ) return DBL_MAX;
+
+  return 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* XRayFluoBiasing::PostStepDoIt(const G4Track& track, 
+                                                 const G4Step&)
+{
+  aParticleChange.Initialize(track);
+
+  // Cone from the emission point around the detector bounding sphere
+  auto axis = fDetectorBox.GetCenter() - track.GetPosition();
+  auto distance = axis.mag();
+  auto radius = fDetectorBox.GetRadius();
+  if ( distance <= radius ) return &aParticleChange;
+  axis /= distance;
+
+  auto sinAlpha = radius/distance;
+  auto cosAlpha = std::sqrt(1. - sinAlpha*sinAlpha);
+  auto coneFraction = 0.5*(1. - cosAlpha); // solid angle / 4pi
+  if ( coneFraction <= 0. ) return &aParticleChange;
+
+  // Sample the mixture of the cone and of the isotropic emission
+  G4ThreeVector direction;
+  G4bool inCone = true;
+  if ( G4UniformRand() < fFraction ) {
+    auto cosTheta = 1. - G4UniformRand()*(1. - cosAlpha);
+    auto sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+    auto phi = twopi*G4UniformRand();
+    direction.set(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+    direction.rotateUz(axis);
+  } 
+  else {
+    auto cosTheta = 2.*G4UniformRand() - 1.;
+    auto sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+    auto phi = twopi*G4UniformRand();
+    direction.set(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+    inCone = ( direction.dot(axis) >= cosAlpha );
+  }
+
+  // Density of the mixture relative to the isotropic density
+  auto density = 1. - fFraction;
+  if ( inCone ) density += fFraction/coneFraction;
+
+  aParticleChange.ProposeMomentumDirection(direction);
+  aParticleChange.ProposeWeight(track.GetWeight()/density);
+  return &aParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayForkMessenger.cc
+/// \brief Implementation of the XRayForkMessenger class
+
+#include "XRayForkMessenger.hh"
+#include "XRayForkRunner.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayForkMessenger::XRayForkMessenger(XRayForkRunner* forkRunner)
+ : G4UImessenger(),
+   fForkRunner(forkRunner)
+{
+  fForkDir = new G4UIdirectory("/xray/fork/");
+  fForkDir->SetGuidance("Multi-process mode, with a serial run manager");
+
+  fNofProcessesCmd = new G4UIcmdWithAnInteger("/xray/fork/nofProcesses",this);
+  fNofProcessesCmd->SetGuidance("Set the number of processes forked by /xray/fork/beamOn.");
+  fNofProcessesCmd->SetParameterName("nofProcesses",false);
+  fNofProcessesCmd->SetRange("nofProcesses>0");
+  fNofProcessesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/xray/fork/beamOn",this);
+  fBeamOnCmd->SetGuidance("Build the physics tables, then share the events");
+  fBeamOnCmd->SetGuidance("between forked processes and merge their results.");
+  fBeamOnCmd->SetParameterName("nofEvents",false);
+  fBeamOnCmd->SetRange("nofEvents>=0");
+  fBeamOnCmd->AvailableForStates(G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayForkMessenger::~XRayForkMessenger()
+{
+  delete fNofProcessesCmd;
+  delete fBeamOnCmd;
+  delete fForkDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayForkMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fNofProcessesCmd ) 
+   { fForkRunner->SetNofProcesses(fNofProcessesCmd->GetNewIntValue(newValue)); }
+
+  if ( command == fBeamOnCmd ) 
+   { fForkRunner->BeamOn(fBeamOnCmd->GetNewIntValue(newValue)); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,227 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayForkRunner.cc
+/// \brief Implementation of the XRayForkRunner class
+
+#include "XRayForkRunner.hh"
+#include "XRayForkMessenger.hh"
+#include "XRayRunAction.hh"
+#include "XRayPrimaryGeneratorAction.hh"
+
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Threading.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define XRAY_FORK_SUPPORTED 1
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+  // slot header: completion flag, number of events, real time
+  const std::size_t kHeaderSize = 3;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayForkRunner::XRayForkRunner()
+ : fMessenger(nullptr),
+   fNofProcesses(1),
+   fNextRunID(0)
+{
+  fMessenger = new XRayForkMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayForkRunner::~XRayForkRunner()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayForkRunner::BeamOn(G4int nofEvents)
+{
+  auto runManager = G4RunManager::GetRunManager();
+  auto runAction = dynamic_cast<XRayRunAction*>(
+    const_cast<G4UserRunAction*>(runManager->GetUserRunAction()));
+  auto primaryGenerator = dynamic_cast<XRayPrimaryGeneratorAction*>(
+    const_cast<G4VUserPrimaryGeneratorAction*>(
+      runManager->GetUserPrimaryGeneratorAction()));
+
+#ifdef XRAY_FORK_SUPPORTED
+  G4bool forkable = ( runAction != nullptr )
+                    && ! G4Threading::IsMultithreadedApplication();
+#else
+  G4bool forkable = false;
+#endif
+  if ( fNofProcesses <= 1 || ! forkable ) {
+    if ( fNofProcesses > 1 ) {
+      G4ExceptionDescription msg;
+      msg << "The multi-process mode needs a serial run manager" << G4endl;
+      msg << "(exampleXRay -r serial) on a POSIX system," << G4endl;
+      msg << "the events are processed in this process.";
+      G4Exception("XRayForkRunner::BeamOn()",
+        "MyCode0007", JustWarning, msg);
+    }
+    runManager->BeamOn(nofEvents);
+    return;
+  }
+
+#ifdef XRAY_FORK_SUPPORTED
+  // The run of no event does not count as a run: the forked run takes 
+  // the ID which follows the last real one, or the last forked one
+  auto lastRun = runManager->GetCurrentRun();
+  G4int runID = std::max(fNextRunID, lastRun ? lastRun->GetRunID() + 1 : 0);
+  fNextRunID = runID + 1;
+
+  // Build the physics tables once, before the processes share them
+  runManager->BeamOn(0);
+
+  // One MixMax stream per process and run, (i+1, n, run+1, job seed):
+  // the job seed, drawn by the parent, follows its seeds, and the streams
+  // do not collide with those of the shards, (i+1, n, 0, 0) (XRayShard)
+  long jobSeed = long(4294967295.*G4UniformRand());
+
+  // One slot of shared memory per process
+  const std::size_t slotSize = kHeaderSize + runAction->GetProcessDataSize();
+  const std::size_t bytes = fNofProcesses*slotSize*sizeof(G4double);
+  auto memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, 
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if ( memory == MAP_FAILED ) {
+    G4ExceptionDescription msg;
+    msg << "The shared memory of the processes cannot be mapped," << G4endl;
+    msg << "the events are processed in this process.";
+    G4Exception("XRayForkRunner::BeamOn()",
+      "MyCode0007", JustWarning, msg);
+    runManager->BeamOn(nofEvents);
+    return;
+  }
+  auto slots = static_cast<G4double*>(memory);
+  std::fill(slots, slots + fNofProcesses*slotSize, 0.);
+
+  G4cout << "Forking " << fNofProcesses << " processes for " 
+         << nofEvents << " events" << G4endl;
+  G4cout.flush();
+  std::cout.flush();
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<pid_t> pids;
+  for ( G4int i=0; i<fNofProcesses; ++i ) {
+    auto pid = fork();
+    if ( pid < 0 ) {
+      G4ExceptionDescription msg;
+      msg << "The process " << i << " cannot be forked.";
+      G4Exception("XRayForkRunner::BeamOn()",
+        "MyCode0007", JustWarning, msg);
+      continue;
+    }
+    if ( pid > 0 ) {
+      pids.push_back(pid);
+      continue;
+    }
+
+    // The forked process: its stream, primaries, events and outputs
+    long processSeeds[5] = { i + 1, fNofProcesses, runID + 1, jobSeed, 0 };
+    G4Random::setTheSeeds(processSeeds, 4);
+    if ( primaryGenerator ) primaryGenerator->SetProcess(i, fNofProcesses);
+    runManager->SetRunIDCounter(runID);
+    runAction->SetForkedProcess(i);
+
+    G4int first = G4int(G4long(nofEvents)*i/fNofProcesses);
+    G4int last = G4int(G4long(nofEvents)*(i + 1)/fNofProcesses);
+    auto processStart = std::chrono::steady_clock::now();
+    runManager->BeamOn(last - first);
+    std::chrono::duration<G4double> elapsed 
+      = std::chrono::steady_clock::now() - processStart;
+
+    auto slot = slots + i*slotSize;
+    slot[1] = last - first;
+    slot[2] = elapsed.count();
+    runAction->ExportProcessData(slot + kHeaderSize);
+    slot[0] = 1.;
+
+    G4cout.flush();
+    std::cout.flush();
+    _exit(0);
+  }
+
+  // Wait for the processes
+  G4int nofFailed = fNofProcesses - G4int(pids.size());
+  for ( auto pid : pids ) {
+    G4int status = 0;
+    if ( waitpid(pid, &status, 0) < 0 
+         || ! WIFEXITED(status) || WEXITSTATUS(status) != 0 ) ++nofFailed;
+  }
+  std::chrono::duration<G4double> elapsed 
+    = std::chrono::steady_clock::now() - start;
+
+  // Merge the completed processes in the parent run action
+  G4int nofMerged = 0;
+  G4int nofMergedEvents = 0;
+  for ( G4int i=0; i<fNofProcesses; ++i ) {
+    const auto slot = slots + i*slotSize;
+    if ( slot[0] != 1. ) continue;
+    ++nofMerged;
+    nofMergedEvents += G4int(slot[1]);
+  }
+  if ( nofFailed > 0 || nofMerged < fNofProcesses ) {
+    G4ExceptionDescription msg;
+    msg << nofFailed << " of the " << fNofProcesses 
+        << " processes failed," << G4endl;
+    msg << "the results of the " << nofMerged << " completed ones are merged.";
+    G4Exception("XRayForkRunner::BeamOn()",
+      "MyCode0007", JustWarning, msg);
+  }
+
+  G4Run run;
+  run.SetRunID(runID);
+  run.SetNumberOfEventToBeProcessed(nofEvents);
+  runAction->SetForkedRun(nofMergedEvents, elapsed.count());
+  runAction->BeginOfRunAction(&run);
+  for ( G4int i=0; i<fNofProcesses; ++i ) {
+    const auto slot = slots + i*slotSize;
+    if ( slot[0] == 1. ) runAction->ImportProcessData(slot + kHeaderSize);
+  }
+  runAction->EndOfRunAction(&run);
+  runManager->SetRunIDCounter(fNextRunID);
+
+  munmap(memory, bytes);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
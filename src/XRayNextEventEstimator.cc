@@ -0,0 +1,143 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayNextEventEstimator.cc
+/// \brief Implementation of the XRayNextEventEstimator class
+
+#include "XRayNextEventEstimator.hh"
+#include "XRayDetectorConstruction.hh"
+#include "XRayAttenuation.hh"
+
+#include "G4Material.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayNextEventEstimator::XRayNextEventEstimator(
+                          const XRayDetectorConstruction* detConstruction)
+ : fDetConstruction(detConstruction),
+   fCalculator(nullptr),
+   fTargetSolid(nullptr),
+   fTargetMaterial(nullptr),
+   fWorldMaterial(nullptr),
+   fDetNormalAxis(2)
+{
+  fCalculator = new XRayAttenuation();
+  for ( G4int i=0; i<3; ++i ) fDetHalfSizes[i] = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayNextEventEstimator::~XRayNextEventEstimator()
+{
+  delete fCalculator;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayNextEventEstimator::Prepare()
+{
+  auto targetPV = fDetConstruction->GetTargetPV();
+  fTargetSolid = targetPV->GetLogicalVolume()->GetSolid();
+  fTargetCenter = targetPV->GetTranslation();
+  fTargetMaterial = targetPV->GetLogicalVolume()->GetMaterial();
+
+  auto detectorPV = fDetConstruction->GetDetectorPV();
+  fWorldMaterial = detectorPV->GetMotherLogical()->GetMaterial();
+
+  // The detector is seen as a rectangle normal to its thinnest side
+  fDetNormalAxis = 2;
+  G4ThreeVector pMin, pMax;
+  detectorPV->GetLogicalVolume()->GetSolid()->BoundingLimits(pMin, pMax);
+  fDetCenter = detectorPV->GetTranslation() + 0.5*(pMin + pMax);
+  for ( G4int i=0; i<3; ++i ) {
+    fDetHalfSizes[i] = 0.5*(pMax[i] - pMin[i]);
+    if ( fDetHalfSizes[i] < fDetHalfSizes[fDetNormalAxis] ) fDetNormalAxis = i;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayNextEventEstimator::Estimate(const G4ThreeVector& position, 
+                                          G4double energy)
+{
+  // Sample a point on the detector surface
+  auto point = fDetCenter;
+  auto area = 1.;
+  for ( G4int i=0; i<3; ++i ) {
+    if ( i == fDetNormalAxis ) continue;
+    point[i] += (2.*G4UniformRand() - 1.)*fDetHalfSizes[i];
+    area *= 2.*fDetHalfSizes[i];
+  }
+
+  auto path = point - position;
+  auto distance2 = path.mag2();
+  if ( distance2 <= 0. ) return 0.;
+  auto distance = std::sqrt(distance2);
+  auto direction = path/distance;
+
+  // Solid angle of the detector surface seen from the emission point
+  auto cosTheta = std::fabs(direction[fDetNormalAxis]);
+  auto probability = area*cosTheta/(4.*pi*distance2);
+
+  // Attenuation along the path in the target and in the world
+  auto targetPath = 0.;
+  auto localPosition = position - fTargetCenter;
+  if ( fTargetSolid->Inside(localPosition) != kOutside ) {
+    targetPath 
+      = std::min(fTargetSolid->DistanceToOut(localPosition, direction), distance);
+  }
+  auto worldPath = distance - targetPath;
+
+  auto mu = GetAttenuation(fTargetMaterial, energy)*targetPath
+          + GetAttenuation(fWorldMaterial, energy)*worldPath;
+
+  return probability*std::exp(-mu);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayNextEventEstimator::GetAttenuation(const G4Material* material,
+                                                G4double energy)
+{
+  auto key = std::make_pair(material, energy);
+  auto it = fAttenuations.find(key);
+  if ( it != fAttenuations.end() ) return it->second;
+
+  auto mu = fCalculator->Compute(material, energy);
+  fAttenuations[key] = mu;
+
+  return mu;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,130 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayPhaseSpaceFile.cc
+/// \brief Implementation of the XRayPhaseSpaceFile class
+
+#include "XRayPhaseSpaceFile.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayPhaseSpaceFile::XRayPhaseSpaceFile()
+ : fData(nullptr),
+   fSize(0),
+   fNofRecords(0),
+   fRecords(nullptr)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayPhaseSpaceFile::~XRayPhaseSpaceFile()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayPhaseSpaceFile::Open(const G4String& fileName)
+{
+  Close();
+
+  G4ExceptionDescription msg;
+  auto fd = open(fileName.c_str(), O_RDONLY);
+  struct stat status;
+  if ( fd < 0 || fstat(fd, &status) != 0 ) {
+    msg << "Cannot open the phase-space file " << fileName;
+  }
+  else if ( std::size_t(status.st_size) < sizeof(XRayPhaseSpaceHeader) ) {
+    msg << "The phase-space file " << fileName << " has no header";
+  }
+  else {
+    fSize = status.st_size;
+    fData = mmap(nullptr, fSize, PROT_READ, MAP_SHARED, fd, 0);
+    if ( fData == MAP_FAILED ) {
+      fData = nullptr;
+      msg << "Cannot map the phase-space file " << fileName;
+    }
+  }
+  if ( fd >= 0 ) close(fd);
+
+  if ( fData ) {
+    auto header = static_cast<const XRayPhaseSpaceHeader*>(fData);
+    auto nofRecords 
+      = (fSize - sizeof(XRayPhaseSpaceHeader))/sizeof(XRayPhaseSpaceRecord);
+    if ( std::strncmp(header->fMagic, "XRPS", 4) != 0 
+         || header->fVersion != kXRayPhaseSpaceVersion ) {
+      msg << fileName << " is not a phase-space file of version " 
+          << kXRayPhaseSpaceVersion;
+    }
+    else if ( header->fNofRecords > nofRecords ) {
+      msg << "The phase-space file " << fileName << " is truncated";
+    }
+    else {
+      fNofRecords = header->fNofRecords;
+      fRecords = reinterpret_cast<const XRayPhaseSpaceRecord*>(header + 1);
+      return true;
+    }
+  }
+
+  G4Exception("XRayPhaseSpaceFile::Open()", "MyCode0004", JustWarning, msg);
+  Close();
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhaseSpaceFile::Close()
+{
+  if ( fData ) munmap(fData, fSize);
+  fData = nullptr;
+  fSize = 0;
+  fNofRecords = 0;
+  fRecords = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhaseSpaceFile::Advise(std::uint64_t first, std::uint64_t last) const
+{
+  if ( ! fData || first >= last ) return;
+
+  // madvise() needs a page-aligned address
+  auto pageSize = std::size_t(sysconf(_SC_PAGESIZE));
+  auto begin = reinterpret_cast<std::size_t>(fRecords + first);
+  auto end = reinterpret_cast<std::size_t>(fRecords + last);
+  auto alignedBegin = begin - begin % pageSize;
+  madvise(reinterpret_cast<void*>(alignedBegin), end - alignedBegin, 
+          MADV_SEQUENTIAL);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,6 +33,10 @@
 
 #include "XRayPhysicsList.hh"
 #include "XRayPhysicsListMessenger.hh"
+#include "XRayPhysicsTableCache.hh"
+#include "XRayEmLitePhysics.hh"
+#include "XRayTargetResponse.hh"
+#include "XRayTargetResponseModel.hh"
 
 #include "G4SystemOfUnits.hh"
 #include "G4LossTableManager.hh"
@@ -49,9 +53,20 @@
 #include "G4EmLivermorePhysics.hh"
 #include "G4EmPenelopePhysics.hh"
 #include "G4UAtomicDeexcitation.hh"
+#include "G4GenericBiasingPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4EmParameters.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4ProductionCuts.hh"
+#include "G4RegionStore.hh"
+#include "G4PhysicsModelCatalog.hh"
+#include "G4Threading.hh"
+#include "G4Region.hh"
 
 #include "G4Decay.hh"
 #include "XRayStepMax.hh"
+#include "XRayFluoBiasing.hh"
+#include "XRayCulling.hh"
 
 #include "G4UnitsTable.hh"
 
@@ -83,8 +98,10 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-XRayPhysicsList::XRayPhysicsList() : G4VModularPhysicsList()
+XRayPhysicsList::XRayPhysicsList(G4bool isLite) : G4VModularPhysicsList()
 {
+  lite = isLite;
+
   pMessenger = new XRayPhysicsListMessenger(this); 
    
   // EM physics
@@ -100,9 +117,37 @@ XRayPhysicsList::XRayPhysicsList() : G4VModularPhysicsList()
   SetVerboseLevel(1);
 
   // EM physics
-  emName = G4String("emlivermore");
-  emPhysicsList = new G4EmLivermorePhysics;
+  if (lite) {
+    emName = G4String("xray-lite");
+    emPhysicsList = new XRayEmLitePhysics(emName);
+
+    // Tables restricted to the X-ray energies, before the UI commands
+    G4EmParameters* emParams = G4EmParameters::Instance();
+    emParams->SetMinEnergy(10*eV);
+    emParams->SetMaxEnergy(100*keV);
+  } else {
+    emName = G4String("emlivermore");
+    emPhysicsList = new G4EmLivermorePhysics;
+  }
+
+  // Biasing
+  forceCollision = false;
+  biasingPhysics = nullptr;
+  fluoBiasing = 0.;
+
+  // Full transport in the world
+  airTransport = "none";
+  fastSimulationPhysics = nullptr;
+
+  // Full simulation of the target, response table of 1 - 50 keV photons
+  responseMode = "none";
+  responseFile = "XRayTargetResponse.xrtr";
+  responseEmin = 1.*keV;
+  responseEmax = 50.*keV;
+  targetResponse = nullptr;
 
+  // Physics tables cache, off until a directory is set
+  tableCache = new XRayPhysicsTableCache(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -110,6 +155,10 @@ XRayPhysicsList::XRayPhysicsList() : G4VModularPhysicsList()
 XRayPhysicsList::~XRayPhysicsList()
 {
   delete emPhysicsList;
+  delete biasingPhysics;
+  delete fastSimulationPhysics;
+  delete targetResponse;
+  delete tableCache;
   delete pMessenger;  
 }
 
@@ -117,6 +166,13 @@ XRayPhysicsList::~XRayPhysicsList()
 
 void XRayPhysicsList::ConstructParticle()
 {
+  if (lite) {
+    G4Geantino::GeantinoDefinition();
+    G4ChargedGeantino::ChargedGeantinoDefinition();
+    emPhysicsList->ConstructParticle();
+    return;
+  }
+
   // pseudo-particles
   G4Geantino::GeantinoDefinition();
   G4ChargedGeantino::ChargedGeantinoDefinition();
@@ -154,8 +210,35 @@ void XRayPhysicsList::ConstructProcess()
 {
   AddTransportation();
   emPhysicsList->ConstructProcess();
-  AddDecay();  
-  AddStepMax();
+  if (!lite) {
+    AddDecay();  
+    AddStepMax();
+  }
+
+  // Wrap the gamma processes for biasing, once all of them are defined
+  if (biasingPhysics) biasingPhysics->ConstructProcess();
+
+  // Emission of the fluorescence toward the detector, configured at each
+  // run by XRayStackingAction; added after the biasing wrappers
+  if (emName == "emlivermore" || emName == "empenelope" || lite) {
+    G4Gamma::Gamma()->GetProcessManager()
+      ->AddDiscreteProcess(new XRayFluoBiasing());
+  }
+
+  // Culling of the photons leaving the target, configured at each run
+  // by XRayStackingAction as well
+  G4Gamma::Gamma()->GetProcessManager()->AddDiscreteProcess(new XRayCulling());
+
+  // Fast simulation manager process, for the air transport model
+  if (fastSimulationPhysics) fastSimulationPhysics->ConstructProcess();
+
+  // Creator model ID of the fluorescence photons of the target response
+  // model, told apart by the scoring; registered once, on the master
+  if (G4Threading::IsMasterThread() && 
+      XRayTargetResponseModel::GetFluoModelID() < 0) {
+    XRayTargetResponseModel::SetFluoModelID(
+      G4PhysicsModelCatalog::Register("XRayTargetResponseFluo"));
+  }
 
   // Em options
   //
@@ -224,6 +307,13 @@ void XRayPhysicsList::AddPhysicsList(const G4String& name)
 
   if (name == emName) return;
 
+  // The other constructors need the particles of the full list
+  if (lite) {
+    G4cout << "PhysicsList::AddPhysicsList: <" << name << ">"
+           << " is not available with <" << emName << ">" << G4endl;
+    return;
+  }
+
   if (name == "emlivermore") {
 
     emName = name;
@@ -264,6 +354,11 @@ void XRayPhysicsList::AddPhysicsList(const G4String& name)
            << " is not defined"
            << G4endl;
   }
+
+  if (fluoBiasing > 0. && GetFluoBiasing() == 0.) {
+    G4cout << "PhysicsList::AddPhysicsList: the fluorescence biasing"
+           << " is not applied with <" << emName << ">" << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -281,6 +376,19 @@ void XRayPhysicsList::SetCuts()
   SetCutValue(cutForElectron, "e-");
   SetCutValue(cutForPositron, "e+");
 
+  // The regions are defined by the detector construction, 
+  // before the cuts are set
+  for (const auto& regionCut : regionCuts) ApplyCutForRegion(regionCut, true);
+  for (const auto& region : deexRegions) GetOwnCuts(region);
+
+  // The cuts are converted to energies within the EM tables window
+  if (lite) {
+    G4ProductionCutsTable* cutsTable 
+      = G4ProductionCutsTable::GetProductionCutsTable();
+    cutsTable->SetEnergyRange(cutsTable->GetLowEdgeEnergy(),
+                              G4EmParameters::Instance()->MaxKinEnergy());
+  }
+
   if (verboseLevel>0) DumpCutValuesTable();
 }
 
@@ -313,7 +421,8 @@ void XRayPhysicsList::SetCutForPositron(G4double cut)
 void XRayPhysicsList::SetCutForProton(G4double cut)
 {
   cutForProton = cut;
-  SetParticleCuts(cutForProton, G4Proton::Proton());
+  // by name, the proton is not constructed in the lite configuration
+  SetParticleCuts(cutForProton, "proton");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -332,4 +441,197 @@ void XRayPhysicsList::SetPIXE(G4bool value)
   if(de) { de->SetPIXE(value); }
 }
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
\ No newline at end of file
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetForceCollision(G4bool value)
+{
+  // The biasing operator itself is attached to the target 
+  // in XRayDetectorConstruction::ConstructSDandField()
+  forceCollision = value;
+
+  if (forceCollision && !biasingPhysics) {
+    G4GenericBiasingPhysics* genericBiasing = new G4GenericBiasingPhysics();
+    genericBiasing->Bias("gamma");
+    biasingPhysics = genericBiasing;
+  } 
+  else if (!forceCollision && biasingPhysics) {
+    delete biasingPhysics;
+    biasingPhysics = nullptr;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetAirTransport(const G4String& mode)
+{
+  // The model itself is attached to the world region
+  // in XRayDetectorConstruction::ConstructSDandField()
+  airTransport = mode;
+  UpdateFastSimulation();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetTargetResponse(const G4String& mode, 
+                                        const G4String& fileName)
+{
+  // The model, or the sensitive detector filling the table, is attached
+  // to the target in XRayDetectorConstruction::ConstructSDandField()
+  delete targetResponse;
+  targetResponse = nullptr;
+  responseMode = mode;
+  responseFile = fileName;
+
+  // The table is read once, and shared by the models of all the threads
+  if (responseMode == "use") {
+    targetResponse = new XRayTargetResponse("TargetResponse");
+    if (!targetResponse->Read(responseFile)) {
+      G4ExceptionDescription msg;
+      msg << "Cannot read the target response table " << responseFile 
+          << ", the target is fully simulated.";
+      G4Exception("XRayPhysicsList::SetTargetResponse()",
+        "MyCode0011", JustWarning, msg);
+      delete targetResponse;
+      targetResponse = nullptr;
+      responseMode = "none";
+    }
+  }
+  UpdateFastSimulation();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetTargetResponseRange(G4double emin, G4double emax)
+{
+  responseEmin = emin;
+  responseEmax = emax;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::UpdateFastSimulation()
+{
+  // The fast simulation process of the gamma serves all the models
+  G4bool fastSimulation = (airTransport != "none" || responseMode == "use");
+
+  if (fastSimulation && !fastSimulationPhysics) {
+    G4FastSimulationPhysics* fastSimulationPhys = new G4FastSimulationPhysics();
+    fastSimulationPhys->ActivateFastSimulation("gamma");
+    fastSimulationPhysics = fastSimulationPhys;
+  }
+  else if (!fastSimulation && fastSimulationPhysics) {
+    delete fastSimulationPhysics;
+    fastSimulationPhysics = nullptr;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetFluoBiasing(G4double value)
+{
+  // The emission directions are biased by XRayFluoBiasing
+  fluoBiasing = value;
+
+  if (fluoBiasing > 0. && GetFluoBiasing() == 0.) {
+    G4cout << "PhysicsList::SetFluoBiasing: the fluorescence biasing"
+           << " is only applied with emlivermore, empenelope and xray-lite"
+           << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayPhysicsList::GetFluoBiasing() const
+{
+  // The biasing relies on the isotropic emission of the fluorescence
+  // by the atomic deexcitation of the low-energy photo-electric models
+  if (emName == "emlivermore" || emName == "empenelope" || lite) {
+    return fluoBiasing;
+  }
+  return 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetTableCache(const G4String& directory)
+{
+  tableCache->SetDirectory(directory);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // "World" is the default region
+  G4String GetRegionName(const G4String& name)
+  {
+    if (name == "World" || name == "world") return "DefaultRegionForTheWorld";
+    return name;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetCutForRegion(const G4String& region, 
+                                      const G4String& particle, G4double cut)
+{
+  RegionCut regionCut = { GetRegionName(region), particle, cut };
+  regionCuts.push_back(regionCut);
+
+  // Before the initialization, the cut is applied by SetCuts()
+  ApplyCutForRegion(regionCut, false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayPhysicsList::ApplyCutForRegion(const RegionCut& regionCut, 
+                                          G4bool verbose)
+{
+  G4ProductionCuts* cuts = GetOwnCuts(regionCut.region);
+  if (!cuts) {
+    if (verbose) {
+      G4cout << "PhysicsList::SetCuts: no region <" << regionCut.region 
+             << ">, its cuts are not set" << G4endl;
+    }
+    return false;
+  }
+
+  cuts->SetProductionCut(regionCut.cut, regionCut.particle);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ProductionCuts* XRayPhysicsList::GetOwnCuts(const G4String& name)
+{
+  G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+  if (!region) return nullptr;
+
+  // A region shares the default cuts until it is given its own
+  G4ProductionCuts* defaultCuts 
+    = G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+  G4ProductionCuts* cuts = region->GetProductionCuts();
+  if (!cuts || (cuts == defaultCuts && name != "DefaultRegionForTheWorld")) {
+    cuts = new G4ProductionCuts(*defaultCuts);
+    region->SetProductionCuts(cuts);
+  }
+  return cuts;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsList::SetDeexcitation(const G4String& region,
+                                      G4bool fluo, G4bool auger, G4bool pixe)
+{
+  // The deexcitation is active per couple: a region sharing the default 
+  // cuts would share its couples with the world. Before the initialization,
+  // the region is given its own cuts by SetCuts()
+  deexRegions.push_back(GetRegionName(region));
+  GetOwnCuts(deexRegions.back());
+
+  // The deexcitation flags of the whole run (/phys/fluo, /phys/pixe) 
+  // still apply on top of the region ones
+  G4EmParameters::Instance()->SetDeexActiveRegion(GetRegionName(region), 
+                                                  fluo, auger, pixe);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -34,9 +34,14 @@
 #include "XRayPhysicsList.hh"
 #include "G4RunManager.hh"
 #include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+
+#include <sstream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -88,6 +93,100 @@ XRayPhysicsListMessenger::XRayPhysicsListMessenger(XRayPhysicsList* pPhys)
   pixeCmd->SetGuidance("Set PIXE on/off.");
   pixeCmd->SetParameterName("pixe",false);
   pixeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);  
+
+  forceCollisionCmd = new G4UIcmdWithABool("/phys/forceCollision",this);  
+  forceCollisionCmd->SetGuidance("Force the gamma to interact in the target.");
+  forceCollisionCmd->SetGuidance("The statistical weights are carried to the tallies.");
+  forceCollisionCmd->SetParameterName("force",true);
+  forceCollisionCmd->SetDefaultValue(true);
+  forceCollisionCmd->AvailableForStates(G4State_PreInit);  
+
+  airTransportCmd = new G4UIcmdWithAString("/phys/airTransport",this);  
+  airTransportCmd->SetGuidance("Move the gamma through the world to the next volume");
+  airTransportCmd->SetGuidance("in one step, with the air attenuation applied to the");
+  airTransportCmd->SetGuidance("weight or with a Russian roulette (none = full transport).");
+  airTransportCmd->SetParameterName("mode",false);
+  airTransportCmd->SetCandidates("none weight roulette");
+  airTransportCmd->AvailableForStates(G4State_PreInit);  
+
+  fluoBiasingCmd = new G4UIcmdWithADouble("/phys/fluoBiasing",this);  
+  fluoBiasingCmd->SetGuidance("Set the fraction of the fluorescence photons from the");
+  fluoBiasingCmd->SetGuidance("target emitted in a cone toward the detector (0 = off).");
+  fluoBiasingCmd->SetGuidance("Only with emlivermore, empenelope and xray-lite.");
+  fluoBiasingCmd->SetParameterName("fraction",false);
+  fluoBiasingCmd->SetRange("fraction>=0. && fraction<=1.");
+  fluoBiasingCmd->AvailableForStates(G4State_PreInit,G4State_Idle);  
+
+  tableCacheCmd = new G4UIcmdWithAString("/phys/tableCache",this);  
+  tableCacheCmd->SetGuidance("Store the physics tables in, and retrieve them from,");
+  tableCacheCmd->SetGuidance("the given directory (none = no cache). The tables are");
+  tableCacheCmd->SetGuidance("kept per Geant4 version, physics, materials and cuts.");
+  tableCacheCmd->SetParameterName("directory",false);
+  tableCacheCmd->AvailableForStates(G4State_PreInit,G4State_Idle);  
+  tableCacheCmd->SetToBeBroadcasted(false);
+
+  regionGCutCmd = new G4UIcommand("/phys/setRegionGCut",this);  
+  regionGCutCmd->SetGuidance("Set the gamma cut of a region, which then no longer");
+  regionGCutCmd->SetGuidance("follows the global cuts.");
+  regionECutCmd = new G4UIcommand("/phys/setRegionECut",this);  
+  regionECutCmd->SetGuidance("Set the electron and positron cuts of a region, which");
+  regionECutCmd->SetGuidance("then no longer follows the global cuts.");
+  for (auto regionCutCmd : { regionGCutCmd, regionECutCmd }) {
+    G4UIparameter* regionPrm = new G4UIparameter("region",'s',false);
+    regionPrm->SetParameterCandidates("Target Detector World");
+    regionCutCmd->SetParameter(regionPrm);
+    G4UIparameter* cutPrm = new G4UIparameter("cut",'d',false);
+    cutPrm->SetParameterRange("cut>0.");
+    regionCutCmd->SetParameter(cutPrm);
+    G4UIparameter* unitPrm = new G4UIparameter("unit",'s',true);
+    unitPrm->SetDefaultUnit("mm");
+    regionCutCmd->SetParameter(unitPrm);
+    regionCutCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  }
+
+  deexcitationCmd = new G4UIcommand("/phys/deexcitation",this);  
+  deexcitationCmd->SetGuidance("Set the fluorescence, Auger and PIXE of a region.");
+  deexcitationCmd->SetGuidance("Once set for a region, the deexcitation is only");
+  deexcitationCmd->SetGuidance("active in the regions given with this command.");
+  G4UIparameter* regionPrm = new G4UIparameter("region",'s',false);
+  regionPrm->SetParameterCandidates("Target Detector World");
+  deexcitationCmd->SetParameter(regionPrm);
+  G4UIparameter* fluoPrm = new G4UIparameter("fluo",'b',false);
+  deexcitationCmd->SetParameter(fluoPrm);
+  G4UIparameter* augerPrm = new G4UIparameter("auger",'b',true);
+  augerPrm->SetDefaultValue(false);
+  deexcitationCmd->SetParameter(augerPrm);
+  G4UIparameter* pixePrm = new G4UIparameter("pixe",'b',true);
+  pixePrm->SetDefaultValue(false);
+  deexcitationCmd->SetParameter(pixePrm);
+  deexcitationCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  targetResponseCmd = new G4UIcommand("/phys/targetResponse",this);  
+  targetResponseCmd->SetGuidance("Fill the response table of the target during each run");
+  targetResponseCmd->SetGuidance("and write it in the file, with _run<id> before its");
+  targetResponseCmd->SetGuidance("extension (build), or replace the full");
+  targetResponseCmd->SetGuidance("simulation of the target by sampling the table read");
+  targetResponseCmd->SetGuidance("from the file (use).");
+  G4UIparameter* modePrm = new G4UIparameter("mode",'s',false);
+  modePrm->SetParameterCandidates("none build use");
+  targetResponseCmd->SetParameter(modePrm);
+  G4UIparameter* filePrm = new G4UIparameter("file",'s',true);
+  filePrm->SetDefaultValue("XRayTargetResponse.xrtr");
+  targetResponseCmd->SetParameter(filePrm);
+  targetResponseCmd->AvailableForStates(G4State_PreInit);
+
+  responseRangeCmd = new G4UIcommand("/phys/targetResponseRange",this);  
+  responseRangeCmd->SetGuidance("Set the incident energy range of the target response");
+  responseRangeCmd->SetGuidance("table to build.");
+  G4UIparameter* eminPrm = new G4UIparameter("emin",'d',false);
+  responseRangeCmd->SetParameter(eminPrm);
+  G4UIparameter* emaxPrm = new G4UIparameter("emax",'d',false);
+  responseRangeCmd->SetParameter(emaxPrm);
+  G4UIparameter* rangeUnitPrm = new G4UIparameter("unit",'s',true);
+  rangeUnitPrm->SetDefaultUnit("keV");
+  responseRangeCmd->SetParameter(rangeUnitPrm);
+  responseRangeCmd->SetRange("emin>0. && emax>emin");
+  responseRangeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
   
 }
 
@@ -103,6 +202,15 @@ XRayPhysicsListMessenger::~XRayPhysicsListMessenger()
   delete physDir;
   delete fluoCmd;
   delete pixeCmd;
+  delete forceCollisionCmd;
+  delete airTransportCmd;
+  delete fluoBiasingCmd;
+  delete tableCacheCmd;
+  delete regionGCutCmd;
+  delete regionECutCmd;
+  delete deexcitationCmd;
+  delete targetResponseCmd;
+  delete responseRangeCmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -140,6 +248,67 @@ void XRayPhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newVal
   if( command == pixeCmd )
     { pPhysicsList->SetPIXE(fluoCmd->GetNewBoolValue(newValue));}
 
+  if( command == forceCollisionCmd )
+    { pPhysicsList->SetForceCollision(forceCollisionCmd->GetNewBoolValue(newValue));}
+
+  if( command == airTransportCmd )
+    { pPhysicsList->SetAirTransport(newValue);}
+
+  // The biasing is applied by the stacking action, the physics tables are unchanged
+  if( command == fluoBiasingCmd )
+    { pPhysicsList->SetFluoBiasing(fluoBiasingCmd->GetNewDoubleValue(newValue));
+      return; }
+
+  if( command == regionGCutCmd || command == regionECutCmd )
+    {
+      std::istringstream is(newValue);
+      G4String region, unit;
+      G4double cut;
+      is >> region >> cut >> unit;
+      cut *= G4UIcommand::ValueOf(unit);
+      if (command == regionGCutCmd) {
+        pPhysicsList->SetCutForRegion(region, "gamma", cut);
+      } else {
+        pPhysicsList->SetCutForRegion(region, "e-", cut);
+        pPhysicsList->SetCutForRegion(region, "e+", cut);
+      }
+    }
+
+  if( command == deexcitationCmd )
+    {
+      std::istringstream is(newValue);
+      G4String region, fluo, auger, pixe;
+      is >> region >> fluo >> auger >> pixe;
+      pPhysicsList->SetDeexcitation(region, G4UIcommand::ConvertToBool(fluo),
+                                    G4UIcommand::ConvertToBool(auger),
+                                    G4UIcommand::ConvertToBool(pixe));
+    }
+
+  if( command == targetResponseCmd )
+    {
+      std::istringstream is(newValue);
+      G4String mode, fileName;
+      is >> mode >> fileName;
+      pPhysicsList->SetTargetResponse(mode, fileName);
+    }
+
+  // The table is booked at the beginning of the runs
+  if( command == responseRangeCmd )
+    {
+      std::istringstream is(newValue);
+      G4String unit;
+      G4double emin, emax;
+      is >> emin >> emax >> unit;
+      pPhysicsList->SetTargetResponseRange(emin*G4UIcommand::ValueOf(unit),
+                                           emax*G4UIcommand::ValueOf(unit));
+      return;
+    }
+
+  // The cache does not change the physics
+  if( command == tableCacheCmd )
+    { pPhysicsList->SetTableCache(newValue);
+      return; }
+
   //Notify the run manager that the physics has been modified
   G4RunManager::GetRunManager()->PhysicsHasBeenModified();
 }
@@ -0,0 +1,228 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayPhysicsTableCache.cc
+/// \brief Implementation of the XRayPhysicsTableCache class
+
+#include "XRayPhysicsTableCache.hh"
+#include "XRayPhysicsList.hh"
+
+#include "G4StateManager.hh"
+#include "G4EmParameters.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4IonisParamMat.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Version.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+namespace {
+
+G4bool MakeDirectory(const G4String& path)
+{
+#ifdef _WIN32
+  _mkdir(path.c_str());
+#else
+  mkdir(path.c_str(), 0755);
+#endif
+  // it may exist already
+  struct stat info;
+  return stat(path.c_str(), &info) == 0 && (info.st_mode & S_IFDIR);
+}
+
+const char* const kKeyFileName = "XRayTables.key";
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayPhysicsTableCache::XRayPhysicsTableCache(XRayPhysicsList* physicsList)
+ : G4VStateDependent(),
+   fPhysicsList(physicsList),
+   fPending(false),
+   fRetrieved(false),
+   fBuildTime(0.)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayPhysicsTableCache::~XRayPhysicsTableCache()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsTableCache::SetDirectory(const G4String& directory)
+{
+  fDirectory = ( directory == "none" ) ? G4String() : directory;
+  fBuiltKey = "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayPhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  if ( fDirectory.empty() ) return true;
+
+  // the state manager is still in the previous state
+  auto state = G4StateManager::GetStateManager()->GetCurrentState();
+
+  // Start of a run initialization (also of a new /run/initialize,
+  // which builds no table and is then followed by the run one)
+  if ( state == G4State_Idle && requestedState == G4State_Init ) {
+    fKey = ComputeKey();
+    fPending = ( fKey != fBuiltKey );
+    if ( ! fPending ) return true;
+
+    std::uint64_t hash = 14695981039346656037ull;
+    for ( auto character : fKey ) {
+      hash ^= std::uint8_t(character);
+      hash *= 1099511628211ull;
+    }
+    std::ostringstream entry;
+    entry << fDirectory << "/" << std::hex << std::setw(16) 
+          << std::setfill('0') << hash;
+    fEntry = entry.str();
+
+    fRetrieved = IsStored(fBuildTime);
+    if ( fRetrieved ) fPhysicsList->SetPhysicsTableRetrieved(fEntry);
+    fTimer.Start();
+    return true;
+  }
+
+  // End of the run initialization: the tables are built
+  if ( fPending && state == G4State_Idle && requestedState == G4State_GeomClosed ) {
+    fTimer.Stop();
+    fPending = false;
+    fBuiltKey = fKey;
+    auto time = fTimer.GetRealElapsed();
+    if ( fRetrieved ) {
+      fPhysicsList->ResetPhysicsTableRetrieved();
+      G4cout << "Physics tables retrieved from " << fEntry << G4endl
+             << " run initialization " << time << " s, with the tables"
+             << " built " << fBuildTime << " s";
+      if ( time > 0. ) G4cout << " (x " << fBuildTime/time << ")";
+      G4cout << G4endl;
+    }
+    else {
+      Store(time);
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String XRayPhysicsTableCache::ComputeKey() const
+{
+  std::ostringstream key;
+  key << std::setprecision(17);
+  key << G4Version << "\n";
+  key << "physics " << fPhysicsList->GetEmName() 
+      << " forceCollision " << fPhysicsList->GetForceCollision() << "\n";
+  key << *G4EmParameters::Instance() << "\n";
+
+  auto cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  key << "energy range " << cutsTable->GetLowEdgeEnergy() << " " 
+      << cutsTable->GetHighEdgeEnergy() << "\n";
+
+  for ( auto material : *G4Material::GetMaterialTable() ) {
+    key << "material " << material->GetName() 
+        << " " << material->GetDensity() 
+        << " " << material->GetState()
+        << " " << material->GetTemperature() 
+        << " " << material->GetPressure()
+        << " " << material->GetIonisation()->GetMeanExcitationEnergy();
+    for ( size_t i=0; i<material->GetNumberOfElements(); ++i ) {
+      auto element = material->GetElement(i);
+      key << " " << element->GetName() << " " << element->GetZ() 
+          << " " << element->GetA() << " " << material->GetFractionVector()[i];
+    }
+    key << "\n";
+  }
+
+  for ( auto region : *G4RegionStore::GetInstance() ) {
+    auto cuts = region->GetProductionCuts();
+    if ( ! cuts ) continue;
+    key << "region " << region->GetName();
+    for ( G4int i=0; i<NumberOfG4CutIndex; ++i ) {
+      key << " " << cuts->GetProductionCut(i);
+    }
+    key << "\n";
+  }
+  return key.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayPhysicsTableCache::IsStored(G4double& buildTime) const
+{
+  std::ifstream file(fEntry + "/" + kKeyFileName);
+  if ( ! ( file >> buildTime ) ) return false;
+  file.get(); // end of the first line
+
+  // the whole key, not only its hash
+  std::ostringstream key;
+  key << file.rdbuf();
+  return key.str() == fKey;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPhysicsTableCache::Store(G4double buildTime)
+{
+  if ( ! MakeDirectory(fDirectory) || ! MakeDirectory(fEntry) 
+       || ! fPhysicsList->StorePhysicsTable(fEntry) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot store the physics tables in " << fEntry << ".";
+    G4Exception("XRayPhysicsTableCache::Store()",
+      "MyCode0010", JustWarning, msg);
+    return;
+  }
+
+  // the key file completes the entry
+  std::ofstream file(fEntry + "/" + kKeyFileName);
+  file << std::setprecision(6) << buildTime << "\n" << fKey;
+
+  G4cout << "Physics tables built in " << buildTime << " s, stored in " 
+         << fEntry << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
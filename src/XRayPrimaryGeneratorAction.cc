@@ -28,8 +28,11 @@
 /// \brief Implementation of the XRayPrimaryGeneratorAction class
 
 #include "XRayPrimaryGeneratorAction.hh"
+#include "XRayPrimaryGeneratorMessenger.hh"
+#include "XRayShard.hh"
 
 #include "G4RunManager.hh"
+#include "G4Run.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Box.hh"
@@ -37,14 +40,77 @@
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Threading.hh"
+#include "G4EmParameters.hh"
 #include "Randomize.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+// Next record of the range of this process, shared by its threads
+struct XRayRecordCursor
+{
+  std::mutex fMutex;
+  std::string fKey; // file and range of the records
+  std::atomic<std::uint64_t> fNext{0};
+};
+
+XRayRecordCursor& GetRecordCursor()
+{
+  static XRayRecordCursor cursor;
+  return cursor;
+}
+
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 XRayPrimaryGeneratorAction::XRayPrimaryGeneratorAction()
  : G4VUserPrimaryGeneratorAction(),
-   fParticleGun(nullptr)
+   fParticleGun(nullptr),
+   fMessenger(nullptr),
+   fSpotSize(0.),
+   fDivergence(0.),
+   fBatchSize(1),
+   fPrimariesPerEvent(1),
+   fTiming(false),
+   fSpectrumMode("mono"),
+   fSpectrumFile(""),
+   fTubeVoltage(30.*kilovolt),
+   fTubeAnode("Cu"),
+   fSpectrumChanged(false),
+   fSource("gun"),
+   fPhaseSpaceFile(""),
+   fPhaseSpaceChanged(false),
+   fRecycle(1),
+   fRotate(false),
+   fWrap(false),
+   fRangeBegin(0),
+   fRangeEnd(0),
+   fRecordBlock(1),
+   fRecordNext(0),
+   fRecordEnd(0),
+   fRecordUses(0),
+   fSampler("pseudo"),
+   fSobolSeed(0),
+   fSobolBegin(0),
+   fSobolEnd(0),
+   fProcess(0),
+   fNofProcesses(1),
+   fNext(0),
+   fGenerationTime(0.),
+   fNofGenerated(0)
 {
   G4int nofParticles = 1;
   fParticleGun = new G4ParticleGun(nofParticles);
@@ -56,6 +122,9 @@ XRayPrimaryGeneratorAction::XRayPrimaryGeneratorAction()
   fParticleGun->SetParticleDefinition(particleDefinition);
   fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0.,0.,-1.));
   fParticleGun->SetParticleEnergy(6*keV);
+  fParticleGun->SetParticlePosition(G4ThreeVector(0., 0., 0.));
+
+  fMessenger = new XRayPrimaryGeneratorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -63,45 +132,427 @@ XRayPrimaryGeneratorAction::XRayPrimaryGeneratorAction()
 XRayPrimaryGeneratorAction::~XRayPrimaryGeneratorAction()
 {
   delete fParticleGun;
+  delete fMessenger;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void XRayPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
+void XRayPrimaryGeneratorAction::BeginOfRun()
 {
-  // This function is called at the begining of event
-
   // In order to avoid dependence of PrimaryGeneratorAction
   // on DetectorConstruction class we get world volume 
-  // from G4LogicalVolumeStore
+  // from G4LogicalVolumeStore, once per run
   //
-  G4double worldZHalfLength = 0.;
-  auto worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("World");
+  auto worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("World", false);
 
-  // Check that the world volume has box shape
+  // Check that the world volume has box shape and contains the gun
   G4Box* worldBox = nullptr;
   if (  worldLV ) {
     worldBox = dynamic_cast<G4Box*>(worldLV->GetSolid());
   }
 
   if ( worldBox ) {
-    worldZHalfLength = worldBox->GetZHalfLength();  
+    auto position = fParticleGun->GetParticlePosition();
+    if ( std::fabs(position.x()) > worldBox->GetXHalfLength() ||
+         std::fabs(position.y()) > worldBox->GetYHalfLength() ||
+         std::fabs(position.z()) > worldBox->GetZHalfLength() ) {
+      G4ExceptionDescription msg;
+      msg << "The gun position " << G4BestUnit(position, "Length") 
+          << " is outside the world volume.";
+      G4Exception("XRayPrimaryGeneratorAction::BeginOfRun()",
+        "MyCode0002", JustWarning, msg);
+    }
   }
   else  {
     G4ExceptionDescription msg;
     msg << "World volume of box shape not found." << G4endl;
     msg << "Perhaps you have changed geometry." << G4endl;
-    msg << "The gun will be place in the center.";
-    G4Exception("XRayPrimaryGeneratorAction::GeneratePrimaries()",
+    msg << "The gun position is not checked.";
+    G4Exception("XRayPrimaryGeneratorAction::BeginOfRun()",
       "MyCode0002", JustWarning, msg);
   } 
-  
-  // Set gun position
-  fParticleGun
-    ->SetParticlePosition(G4ThreeVector(0., 0., 0.));
 
-  fParticleGun->GeneratePrimaryVertex(anEvent);
+  if ( fSpectrumChanged ) PrepareSpectrum();
+  if ( fPhaseSpaceChanged && fSource == "phaseSpace" ) PreparePhaseSpace();
+  if ( IsQuasiRandom() ) PrepareSobol();
+  if ( fSource == "gun" ) CheckEnergyRange();
+
+  // Re-sample with the gun settings of this run
+  fNext = fEnergy.size();
+
+  fGenerationTime = 0.;
+  fNofGenerated = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
+{
+  // This function is called at the begining of event
+
+  std::chrono::steady_clock::time_point start;
+  if ( fTiming ) start = std::chrono::steady_clock::now();
+
+  // One vertex per primary, each with its own pre-sampled kinematics;
+  // the gun keeps the nominal settings, the vertices get the sampled ones
+  for ( G4int k=0; k<fPrimariesPerEvent; ++k ) {
+    if ( fNext >= fEnergy.size() ) FillBuffer();
+
+    auto vertex = new G4PrimaryVertex(
+      G4ThreeVector(fPosX[fNext], fPosY[fNext], fPosZ[fNext]), 
+      fParticleGun->GetParticleTime());
+    for ( G4int i=0; i<fParticleGun->GetNumberOfParticlesToBeGenerated(); ++i ) {
+      auto particle 
+        = new G4PrimaryParticle(fParticleGun->GetParticleDefinition());
+      particle->SetKineticEnergy(fEnergy[fNext]);
+      particle->SetMomentumDirection(
+        G4ThreeVector(fDirX[fNext], fDirY[fNext], fDirZ[fNext]));
+      particle->SetCharge(fParticleGun->GetParticleCharge());
+      particle->SetPolarization(fParticleGun->GetParticlePolarization());
+      particle->SetWeight(fWeight[fNext]);
+      vertex->SetPrimary(particle);
+    }
+    anEvent->AddPrimaryVertex(vertex);
+    ++fNext;
+  }
+
+  if ( fTiming ) {
+    std::chrono::duration<G4double> elapsed 
+      = std::chrono::steady_clock::now() - start;
+    fGenerationTime += elapsed.count();
+    ++fNofGenerated;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::FillBuffer()
+{
+  const std::size_t nofRandoms = 6; // per primary
+  const std::size_t size = fBatchSize;
+
+  fPosX.resize(size);
+  fPosY.resize(size);
+  fPosZ.resize(size);
+  fDirX.resize(size);
+  fDirY.resize(size);
+  fDirZ.resize(size);
+  fEnergy.resize(size);
+  fWeight.resize(size);
+
+  if ( fSource == "phaseSpace" && fPhaseSpace.IsOpen() ) {
+    FillBufferFromPhaseSpace(size);
+    fNext = 0;
+    return;
+  }
+
+  fRandoms.resize(nofRandoms*size);
+
+  if ( IsQuasiRandom() ) {
+    // One point of the sequence per primary
+    for ( std::size_t i=0; i<size; ++i ) {
+      fSobol.Next(fRandoms.data() + nofRandoms*i);
+      if ( fSobol.GetIndex() == fSobolEnd ) {
+        fSobol.Skip(fSobolBegin);
+        G4ExceptionDescription msg;
+        msg << "The Sobol points of this thread are exhausted," << G4endl;
+        msg << "they are used again from the first one.";
+        G4Exception("XRayPrimaryGeneratorAction::FillBuffer()",
+          "MyCode0005", JustWarning, msg);
+      }
+    }
+  }
+  else {
+    // One bulk draw for the whole block
+    G4Random::getTheEngine()->flatArray(G4int(fRandoms.size()), fRandoms.data());
+  }
+
+  const auto position  = fParticleGun->GetParticlePosition();
+  const auto direction = fParticleGun->GetParticleMomentumDirection().unit();
+  const auto energy    = fParticleGun->GetParticleEnergy();
+  const auto spotRadius    = 0.5*fSpotSize;
+  const auto cosDivergence = std::cos(fDivergence);
+
+  // The spot lies in the plane orthogonal to the gun direction
+  const auto spotU = direction.orthogonal().unit();
+  const auto spotV = direction.cross(spotU);
+
+  for ( std::size_t i=0; i<size; ++i ) {
+    const auto randoms = fRandoms.data() + nofRandoms*i;
+
+    auto radius = spotRadius*std::sqrt(randoms[0]);
+    auto phi = twopi*randoms[1];
+    auto spot = position 
+              + radius*std::cos(phi)*spotU + radius*std::sin(phi)*spotV;
+    fPosX[i] = spot.x();
+    fPosY[i] = spot.y();
+    fPosZ[i] = spot.z();
+
+    auto cosTheta = 1. - randoms[2]*(1. - cosDivergence);
+    auto sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+    auto psi = twopi*randoms[3];
+    G4ThreeVector beam(sinTheta*std::cos(psi), sinTheta*std::sin(psi), cosTheta);
+    beam.rotateUz(direction);
+    fDirX[i] = beam.x();
+    fDirY[i] = beam.y();
+    fDirZ[i] = beam.z();
+
+    fEnergy[i] = fSpectrum.IsEmpty() 
+               ? energy : fSpectrum.Sample(randoms[4], randoms[5]);
+    fWeight[i] = 1.;
+  }
+
+  fNext = 0;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void XRayPrimaryGeneratorAction::PrepareSpectrum()
+{
+  fSpectrumChanged = false;
+  fSpectrum.Clear();
+
+  G4bool prepared = true;
+  if ( fSpectrumMode == "file" ) {
+    prepared = fSpectrum.LoadFile(fSpectrumFile);
+  }
+  else if ( fSpectrumMode == "tube" ) {
+    prepared = fSpectrum.BuildTube(fTubeVoltage, fTubeAnode);
+  }
+
+  if ( ! prepared ) {
+    G4ExceptionDescription msg;
+    msg << "The " << fSpectrumMode << " spectrum is not available," << G4endl;
+    msg << "the gun energy is used.";
+    G4Exception("XRayPrimaryGeneratorAction::PrepareSpectrum()",
+      "MyCode0003", JustWarning, msg);
+  }
+  else if ( ! fSpectrum.IsEmpty() ) {
+    G4cout << "Primary spectrum: " << fSpectrumMode << ", mean energy "
+           << G4BestUnit(fSpectrum.GetMeanEnergy(), "Energy") << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::CheckEnergyRange() const
+{
+  // The EM tables stop at MaxKinEnergy (100 keV with the lite physics):
+  // above it, the cross sections would be wrong without any notice
+  auto maxEnergy = fSpectrum.IsEmpty() 
+                 ? fParticleGun->GetParticleEnergy() : fSpectrum.GetMaxEnergy();
+  auto maxKinEnergy = G4EmParameters::Instance()->MaxKinEnergy();
+  if ( maxEnergy > maxKinEnergy ) {
+    G4ExceptionDescription msg;
+    msg << "The primary energy reaches " << G4BestUnit(maxEnergy, "Energy")
+        << ", above the upper limit of the EM tables, " 
+        << G4BestUnit(maxKinEnergy, "Energy") << "." << G4endl;
+    msg << "Raise it with /process/eLoss/maxKinEnergy.";
+    G4Exception("XRayPrimaryGeneratorAction::CheckEnergyRange()",
+      "MyCode0014", FatalException, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::FillBufferFromPhaseSpace(std::size_t size)
+{
+  // The records are converted in place, one random angle per primary
+  if ( fRotate ) {
+    fRandoms.resize(size);
+    G4Random::getTheEngine()->flatArray(G4int(size), fRandoms.data());
+  }
+
+  const auto records = fPhaseSpace.GetRecords();
+  for ( std::size_t i=0; i<size; ++i ) {
+    const auto& record = records[fRecordNext];
+    G4double x  = record.fPosition[0]*mm;
+    G4double y  = record.fPosition[1]*mm;
+    G4double dx = record.fDirection[0];
+    G4double dy = record.fDirection[1];
+    if ( fRotate ) {
+      auto phi = twopi*fRandoms[i];
+      auto cosPhi = std::cos(phi);
+      auto sinPhi = std::sin(phi);
+      auto rx = cosPhi*x - sinPhi*y;
+      auto rdx = cosPhi*dx - sinPhi*dy;
+      y  = sinPhi*x + cosPhi*y;
+      dy = sinPhi*dx + cosPhi*dy;
+      x  = rx;
+      dx = rdx;
+    }
+    fPosX[i] = x;
+    fPosY[i] = y;
+    fPosZ[i] = record.fPosition[2]*mm;
+    fDirX[i] = dx;
+    fDirY[i] = dy;
+    fDirZ[i] = record.fDirection[2];
+    fEnergy[i] = record.fEnergy*keV;
+    fWeight[i] = record.fWeight;
+
+    if ( ++fRecordUses < fRecycle ) continue;
+    fRecordUses = 0;
+    if ( ++fRecordNext == fRecordEnd ) ClaimRecords();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::ClaimRecords()
+{
+  // The threads of a process take the blocks of its range in turn, so that
+  // each record is used once whatever the events processed by each thread
+  auto rangeSize = fRangeEnd - fRangeBegin;
+  auto first = GetRecordCursor().fNext.fetch_add(fRecordBlock);
+  // reported once per pass over the range
+  if ( first >= rangeSize && ( ! fWrap || first % rangeSize < fRecordBlock ) ) {
+    G4ExceptionDescription msg;
+    msg << "The phase-space records of this process are exhausted";
+    if ( fWrap ) {
+      msg << "," << G4endl << "they are used again from the first one.";
+      G4Exception("XRayPrimaryGeneratorAction::ClaimRecords()",
+        "MyCode0004", JustWarning, msg);
+    }
+    else {
+      msg << "." << G4endl 
+          << "Use more records, or allow their reuse with "
+          << "/xray/gun/phaseSpace/wrap.";
+      G4Exception("XRayPrimaryGeneratorAction::ClaimRecords()",
+        "MyCode0004", RunMustBeAborted, msg);
+    }
+  }
+  first %= rangeSize;
+  fRecordNext = fRangeBegin + first;
+  fRecordEnd = std::min(fRecordNext + fRecordBlock, fRangeEnd);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::PreparePhaseSpace()
+{
+  fPhaseSpaceChanged = false;
+  if ( ! fPhaseSpace.Open(fPhaseSpaceFile) ) return;
+
+  auto nofRecords = fPhaseSpace.GetNofRecords();
+  if ( nofRecords == 0 ) {
+    G4ExceptionDescription msg;
+    msg << "The phase-space file " << fPhaseSpaceFile << " is empty," << G4endl;
+    msg << "the gun is used.";
+    G4Exception("XRayPrimaryGeneratorAction::PreparePhaseSpace()",
+      "MyCode0004", JustWarning, msg);
+    fPhaseSpace.Close();
+    return;
+  }
+
+  // Contiguous range of records of this process, shared by its threads
+  std::uint64_t part, nofParts;
+  GetPartition(part, nofParts, false);
+  fRangeBegin = nofRecords*part/nofParts;
+  fRangeEnd = nofRecords*(part + 1)/nofParts;
+  if ( fRangeBegin >= fRangeEnd ) {
+    fRangeBegin = 0;
+    fRangeEnd = nofRecords;
+  }
+  fPhaseSpace.Advise(fRangeBegin, fRangeEnd);
+
+  // Blocks small enough to be shared by the threads, large enough to be
+  // read sequentially
+  std::uint64_t nofThreads 
+    = std::max(1, G4Threading::GetNumberOfRunningWorkerThreads());
+  fRecordBlock = std::max<std::uint64_t>(1, 
+    std::min<std::uint64_t>(4096, (fRangeEnd - fRangeBegin)/(16*nofThreads)));
+
+  // The first thread of a new range resets the cursor
+  {
+    auto& cursor = GetRecordCursor();
+    std::ostringstream key;
+    key << fPhaseSpaceFile << ":" << fRangeBegin << "-" << fRangeEnd;
+    std::lock_guard<std::mutex> lock(cursor.fMutex);
+    if ( cursor.fKey != key.str() ) {
+      cursor.fKey = key.str();
+      cursor.fNext = 0;
+    }
+  }
+  fRecordUses = 0;
+  ClaimRecords();
+
+  G4cout << "Phase space: " << fPhaseSpaceFile << ", records " 
+         << fRangeBegin << " - " << fRangeEnd << " of " << nofRecords 
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::PrepareSobol()
+{
+  // Same scrambling on all threads and processes, a new one at each run
+  auto run = G4RunManager::GetRunManager()->GetCurrentRun();
+  auto runID = run ? run->GetRunID() : 0;
+  fSobol.Scramble(fSobolSeed, runID);
+
+  // Block of points of this part of the run
+  std::uint64_t part, nofParts;
+  GetPartition(part, nofParts);
+  std::uint64_t nofBlocks = 1;
+  while ( nofBlocks < nofParts ) nofBlocks *= 2;
+  std::uint64_t blockSize = (std::uint64_t(1) << 32)/nofBlocks;
+  // the end of the last block wraps to 0, as the index of the sequence
+  fSobolBegin = std::uint32_t(part*blockSize);
+  fSobolEnd = std::uint32_t(part*blockSize + blockSize);
+  fSobol.Skip(fSobolBegin);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::GetPartition(std::uint64_t& part,
+                                              std::uint64_t& nofParts,
+                                              G4bool perThread) const
+{
+  // the shards, the forked processes of each shard, then their threads
+  std::uint64_t nofShards = std::max(1, XRayShard::GetNofShards());
+  std::uint64_t shard = XRayShard::GetIndex();
+  std::uint64_t nofThreads = perThread
+    ? std::max(1, G4Threading::GetNumberOfRunningWorkerThreads()) : 1;
+  std::uint64_t thread 
+    = perThread ? std::max(0, G4Threading::G4GetThreadId()) : 0;
+  nofParts = nofShards*fNofProcesses*nofThreads;
+  part = (shard*fNofProcesses + fProcess)*nofThreads + thread;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::SetProcess(G4int index, G4int nofProcesses)
+{
+  if ( index == fProcess && nofProcesses == fNofProcesses ) return;
+  fProcess = index;
+  fNofProcesses = nofProcesses;
+  // the range of records depends on the process
+  if ( fPhaseSpace.IsOpen() ) fPhaseSpaceChanged = true;
+  fNext = fEnergy.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::SetSpotSize(G4double value)
+{
+  fSpotSize = value;
+  fNext = fEnergy.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::SetDivergence(G4double value)
+{
+  fDivergence = value;
+  fNext = fEnergy.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorAction::SetBatchSize(G4int value)
+{
+  fBatchSize = value;
+  fNext = fEnergy.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
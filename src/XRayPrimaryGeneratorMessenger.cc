@@ -0,0 +1,243 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayPrimaryGeneratorMessenger.cc
+/// \brief Implementation of the XRayPrimaryGeneratorMessenger class
+
+#include "XRayPrimaryGeneratorMessenger.hh"
+#include "XRayPrimaryGeneratorAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayPrimaryGeneratorMessenger::XRayPrimaryGeneratorMessenger(
+                                 XRayPrimaryGeneratorAction* primaryGenerator)
+ : G4UImessenger(),
+   fPrimaryGenerator(primaryGenerator)
+{
+  fGunDir = new G4UIdirectory("/xray/gun/");
+  fGunDir->SetGuidance("Primary source, around the /gun/ settings");
+
+  fSpotSizeCmd = new G4UIcmdWithADoubleAndUnit("/xray/gun/spotSize",this);
+  fSpotSizeCmd->SetGuidance("Set the diameter of the source spot.");
+  fSpotSizeCmd->SetParameterName("spotSize",false);
+  fSpotSizeCmd->SetUnitCategory("Length");
+  fSpotSizeCmd->SetRange("spotSize>=0.");
+  fSpotSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fDivergenceCmd = new G4UIcmdWithADoubleAndUnit("/xray/gun/divergence",this);
+  fDivergenceCmd->SetGuidance("Set the half-angle of the beam cone.");
+  fDivergenceCmd->SetParameterName("divergence",false);
+  fDivergenceCmd->SetUnitCategory("Angle");
+  fDivergenceCmd->SetRange("divergence>=0.");
+  fDivergenceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBatchSizeCmd = new G4UIcmdWithAnInteger("/xray/gun/batchSize",this);
+  fBatchSizeCmd->SetGuidance("Set the number of primaries sampled at once.");
+  fBatchSizeCmd->SetGuidance("1 (default) keeps the primaries reproducible event by event.");
+  fBatchSizeCmd->SetParameterName("batchSize",false);
+  fBatchSizeCmd->SetRange("batchSize>0");
+  fBatchSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPrimariesPerEventCmd 
+    = new G4UIcmdWithAnInteger("/xray/gun/primariesPerEvent",this);
+  fPrimariesPerEventCmd->SetGuidance("Set the number of independent primaries per event.");
+  fPrimariesPerEventCmd->SetGuidance("The tallies and histograms remain normalised per primary.");
+  fPrimariesPerEventCmd->SetParameterName("nofPrimaries",false);
+  fPrimariesPerEventCmd->SetRange("nofPrimaries>0");
+  fPrimariesPerEventCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTimingCmd = new G4UIcmdWithABool("/xray/gun/timing",this);
+  fTimingCmd->SetGuidance("Time the primary generation and print its cost per event.");
+  fTimingCmd->SetParameterName("timing",true);
+  fTimingCmd->SetDefaultValue(true);
+  fTimingCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSpectrumCmd = new G4UIcmdWithAString("/xray/gun/spectrum",this);
+  fSpectrumCmd->SetGuidance("Select the energy spectrum of the primaries:");
+  fSpectrumCmd->SetGuidance("  mono: the /gun/energy");
+  fSpectrumCmd->SetGuidance("  file: read from /xray/gun/spectrumFile");
+  fSpectrumCmd->SetGuidance("  tube: X-ray tube model (/xray/gun/tubeVoltage, tubeAnode)");
+  fSpectrumCmd->SetParameterName("spectrum",false);
+  fSpectrumCmd->SetCandidates("mono file tube");
+  fSpectrumCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSpectrumFileCmd = new G4UIcmdWithAString("/xray/gun/spectrumFile",this);
+  fSpectrumFileCmd->SetGuidance("Set the spectrum file, energies in keV:");
+  fSpectrumFileCmd->SetGuidance("  text, 2 columns: bin center, intensity");
+  fSpectrumFileCmd->SetGuidance("  text, 3 columns: bin low, bin high, intensity");
+  fSpectrumFileCmd->SetGuidance("  .bin: records of 3 doubles low, high, intensity");
+  fSpectrumFileCmd->SetParameterName("fileName",false);
+  fSpectrumFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTubeVoltageCmd = new G4UIcmdWithADoubleAndUnit("/xray/gun/tubeVoltage",this);
+  fTubeVoltageCmd->SetGuidance("Set the voltage of the X-ray tube model.");
+  fTubeVoltageCmd->SetParameterName("voltage",false);
+  fTubeVoltageCmd->SetUnitCategory("Electric potential");
+  fTubeVoltageCmd->SetDefaultUnit("kilovolt");
+  fTubeVoltageCmd->SetRange("voltage>0.");
+  fTubeVoltageCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTubeAnodeCmd = new G4UIcmdWithAString("/xray/gun/tubeAnode",this);
+  fTubeAnodeCmd->SetGuidance("Set the anode of the X-ray tube model.");
+  fTubeAnodeCmd->SetParameterName("anode",false);
+  fTubeAnodeCmd->SetCandidates("Ti Cr Cu Mo Rh Ag W");
+  fTubeAnodeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSourceCmd = new G4UIcmdWithAString("/xray/gun/source",this);
+  fSourceCmd->SetGuidance("Select the source of the primaries:");
+  fSourceCmd->SetGuidance("  gun: the /gun/ and /xray/gun/ settings");
+  fSourceCmd->SetGuidance("  phaseSpace: the /xray/gun/phaseSpace/file records");
+  fSourceCmd->SetParameterName("source",false);
+  fSourceCmd->SetCandidates("gun phaseSpace");
+  fSourceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSamplerCmd = new G4UIcmdWithAString("/xray/gun/sampler",this);
+  fSamplerCmd->SetGuidance("Select the sampler of the gun spot, direction and energy:");
+  fSamplerCmd->SetGuidance("  pseudo: the random engine");
+  fSamplerCmd->SetGuidance("  sobol: scrambled Sobol sequence, a new scrambling per run");
+  fSamplerCmd->SetParameterName("sampler",false);
+  fSamplerCmd->SetCandidates("pseudo sobol");
+  fSamplerCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSobolSeedCmd = new G4UIcmdWithAnInteger("/xray/gun/sobolSeed",this);
+  fSobolSeedCmd->SetGuidance("Set the seed of the Sobol scrambling, combined with the run ID.");
+  fSobolSeedCmd->SetParameterName("seed",false);
+  fSobolSeedCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPhaseSpaceDir = new G4UIdirectory("/xray/gun/phaseSpace/");
+  fPhaseSpaceDir->SetGuidance("Phase-space file source");
+
+  fPhaseSpaceFileCmd = new G4UIcmdWithAString("/xray/gun/phaseSpace/file",this);
+  fPhaseSpaceFileCmd->SetGuidance("Set the phase-space file (see tools/xrayPhaseSpace).");
+  fPhaseSpaceFileCmd->SetParameterName("fileName",false);
+  fPhaseSpaceFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRecycleCmd = new G4UIcmdWithAnInteger("/xray/gun/phaseSpace/recycle",this);
+  fRecycleCmd->SetGuidance("Set the number of uses of each record.");
+  fRecycleCmd->SetParameterName("recycle",false);
+  fRecycleCmd->SetRange("recycle>0");
+  fRecycleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRotateCmd = new G4UIcmdWithABool("/xray/gun/phaseSpace/rotate",this);
+  fRotateCmd->SetGuidance("Rotate each record by a random angle around the z axis.");
+  fRotateCmd->SetParameterName("rotate",true);
+  fRotateCmd->SetDefaultValue(true);
+  fRotateCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fWrapCmd = new G4UIcmdWithABool("/xray/gun/phaseSpace/wrap",this);
+  fWrapCmd->SetGuidance("Reuse the records from the first one when they are exhausted;");
+  fWrapCmd->SetGuidance("otherwise the run is aborted.");
+  fWrapCmd->SetParameterName("wrap",true);
+  fWrapCmd->SetDefaultValue(true);
+  fWrapCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayPrimaryGeneratorMessenger::~XRayPrimaryGeneratorMessenger()
+{
+  delete fSpotSizeCmd;
+  delete fDivergenceCmd;
+  delete fBatchSizeCmd;
+  delete fPrimariesPerEventCmd;
+  delete fTimingCmd;
+  delete fSpectrumCmd;
+  delete fSpectrumFileCmd;
+  delete fTubeVoltageCmd;
+  delete fTubeAnodeCmd;
+  delete fSourceCmd;
+  delete fSamplerCmd;
+  delete fSobolSeedCmd;
+  delete fPhaseSpaceFileCmd;
+  delete fRecycleCmd;
+  delete fRotateCmd;
+  delete fWrapCmd;
+  delete fPhaseSpaceDir;
+  delete fGunDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, 
+                                                G4String newValue)
+{
+  if ( command == fSpotSizeCmd ) 
+   { fPrimaryGenerator->SetSpotSize(fSpotSizeCmd->GetNewDoubleValue(newValue)); }
+
+  if ( command == fDivergenceCmd ) 
+   { fPrimaryGenerator->SetDivergence(fDivergenceCmd->GetNewDoubleValue(newValue)); }
+
+  if ( command == fBatchSizeCmd ) 
+   { fPrimaryGenerator->SetBatchSize(fBatchSizeCmd->GetNewIntValue(newValue)); }
+
+  if ( command == fPrimariesPerEventCmd ) 
+   { fPrimaryGenerator->SetPrimariesPerEvent(
+       fPrimariesPerEventCmd->GetNewIntValue(newValue)); }
+
+  if ( command == fTimingCmd ) 
+   { fPrimaryGenerator->SetTiming(fTimingCmd->GetNewBoolValue(newValue)); }
+
+  if ( command == fSpectrumCmd ) 
+   { fPrimaryGenerator->SetSpectrum(newValue); }
+
+  if ( command == fSpectrumFileCmd ) 
+   { fPrimaryGenerator->SetSpectrumFile(newValue); }
+
+  if ( command == fTubeVoltageCmd ) 
+   { fPrimaryGenerator->SetTubeVoltage(fTubeVoltageCmd->GetNewDoubleValue(newValue)); }
+
+  if ( command == fTubeAnodeCmd ) 
+   { fPrimaryGenerator->SetTubeAnode(newValue); }
+
+  if ( command == fSourceCmd ) 
+   { fPrimaryGenerator->SetSource(newValue); }
+
+  if ( command == fSamplerCmd ) 
+   { fPrimaryGenerator->SetSampler(newValue); }
+
+  if ( command == fSobolSeedCmd ) 
+   { fPrimaryGenerator->SetSobolSeed(fSobolSeedCmd->GetNewIntValue(newValue)); }
+
+  if ( command == fPhaseSpaceFileCmd ) 
+   { fPrimaryGenerator->SetPhaseSpaceFile(newValue); }
+
+  if ( command == fRecycleCmd ) 
+   { fPrimaryGenerator->SetRecycle(fRecycleCmd->GetNewIntValue(newValue)); }
+
+  if ( command == fRotateCmd ) 
+   { fPrimaryGenerator->SetRotate(fRotateCmd->GetNewBoolValue(newValue)); }
+
+  if ( command == fWrapCmd ) 
+   { fPrimaryGenerator->SetWrap(fWrapCmd->GetNewBoolValue(newValue)); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
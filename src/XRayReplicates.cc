@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayReplicates.cc
+/// \brief Implementation of the XRayReplicates class
+
+#include "XRayReplicates.hh"
+
+#include <fstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayReplicates::XRayReplicates()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayReplicates::~XRayReplicates()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayReplicates::AddRun(const G4String& sampler, G4int nofEvents,
+                            const std::vector<std::vector<G4double>>& means)
+{
+  auto& sample = fSamples[std::make_pair(nofEvents, sampler)];
+  if ( sample.fNofRuns == 0 ) {
+    sample.fSum.clear();
+    sample.fSum2.clear();
+    for ( const auto& tally : means ) {
+      sample.fSum.emplace_back(tally.size(), 0.);
+      sample.fSum2.emplace_back(tally.size(), 0.);
+    }
+  }
+  if ( sample.fSum.size() != means.size() ) return;
+
+  for ( std::size_t i=0; i<means.size(); ++i ) {
+    if ( sample.fSum[i].size() != means[i].size() ) return;
+    for ( std::size_t bin=0; bin<means[i].size(); ++bin ) {
+      sample.fSum[i][bin] += means[i][bin];
+      sample.fSum2[i][bin] += means[i][bin]*means[i][bin];
+    }
+  }
+  ++sample.fNofRuns;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayReplicates::Variance(const Sample& sample, std::size_t tally,
+                                  std::size_t bin)
+{
+  auto n = sample.fNofRuns;
+  if ( n < 2 ) return 0.;
+  auto mean = sample.fSum[tally][bin]/n;
+  auto variance = (sample.fSum2[tally][bin] - n*mean*mean)/(n - 1);
+  return variance > 0. ? variance : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayReplicates::Write(const std::vector<G4String>& names,
+                           const G4String& fileName) const
+{
+  std::ofstream file;
+
+  for ( const auto& entry : fSamples ) {
+    if ( entry.first.second != "pseudo" ) continue;
+    auto nofEvents = entry.first.first;
+    auto sobol = fSamples.find(std::make_pair(nofEvents, G4String("sobol")));
+    if ( sobol == fSamples.end() ) continue;
+
+    const auto& pseudoSample = entry.second;
+    const auto& sobolSample = sobol->second;
+    if ( pseudoSample.fNofRuns < 2 || sobolSample.fNofRuns < 2 ) continue;
+
+    if ( ! file.is_open() ) {
+      file.open(fileName);
+      if ( ! file ) {
+        G4cerr << "Cannot open " << fileName << G4endl;
+        return;
+      }
+      file << "events,tally,bin,pseudo runs,pseudo variance,"
+           << "sobol runs,sobol variance,ratio" << "\n";
+    }
+
+    G4cout << G4endl << " ----> sampler variances at " << nofEvents 
+           << " events (" << pseudoSample.fNofRuns << " pseudo, " 
+           << sobolSample.fNofRuns << " sobol runs) " << G4endl << G4endl;
+
+    for ( std::size_t i=0; i<pseudoSample.fSum.size(); ++i ) {
+      if ( i >= sobolSample.fSum.size() || i >= names.size() ) break;
+      G4double pseudoTotal = 0.;
+      G4double sobolTotal = 0.;
+      for ( std::size_t bin=0; bin<pseudoSample.fSum[i].size(); ++bin ) {
+        auto pseudoVariance = Variance(pseudoSample, i, bin);
+        auto sobolVariance = Variance(sobolSample, i, bin);
+        pseudoTotal += pseudoVariance;
+        sobolTotal += sobolVariance;
+        file << nofEvents << "," << names[i] << "," << bin << ","
+             << pseudoSample.fNofRuns << "," << pseudoVariance << ","
+             << sobolSample.fNofRuns << "," << sobolVariance << ","
+             << (sobolVariance > 0. ? pseudoVariance/sobolVariance : 0.) 
+             << "\n";
+      }
+      G4cout << " " << names[i] << " : sum of bin variances pseudo = " 
+             << pseudoTotal << ", sobol = " << sobolTotal;
+      if ( sobolTotal > 0. ) G4cout << ", ratio = " << pseudoTotal/sobolTotal;
+      G4cout << G4endl;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
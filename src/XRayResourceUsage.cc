@@ -0,0 +1,121 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayResourceUsage.cc
+/// \brief Implementation of the XRayResourceUsage class
+
+#include "XRayResourceUsage.hh"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define XRAY_RUSAGE_SUPPORTED 1
+#include <sys/resource.h>
+#endif
+
+std::chrono::steady_clock::time_point XRayResourceUsage::fStart 
+  = std::chrono::steady_clock::now();
+G4bool XRayResourceUsage::fStartupPrinted = false;
+
+namespace {
+  // a "Name:   value kB" line of /proc/self/status, in MB
+  G4double ReadStatus(const std::string& name)
+  {
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while ( std::getline(file, line) ) {
+      if ( line.compare(0, name.size(), name) != 0 ) continue;
+      std::istringstream value(line.substr(name.size()));
+      G4double kilobytes = 0.;
+      value >> kilobytes;
+      return kilobytes/1024.;
+    }
+    return 0.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayResourceUsage::Start()
+{
+  fStart = std::chrono::steady_clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayResourceUsage::GetElapsedTime()
+{
+  std::chrono::duration<G4double> elapsed 
+    = std::chrono::steady_clock::now() - fStart;
+  return elapsed.count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayResourceUsage::GetResidentMemory()
+{
+  return ReadStatus("VmRSS:");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayResourceUsage::GetPeakResidentMemory()
+{
+  auto peak = ReadStatus("VmHWM:");
+#ifdef XRAY_RUSAGE_SUPPORTED
+  if ( peak == 0. ) {
+    struct rusage usage;
+    if ( getrusage(RUSAGE_SELF, &usage) == 0 ) {
+#ifdef __APPLE__
+      peak = usage.ru_maxrss/(1024.*1024.);  // bytes
+#else
+      peak = usage.ru_maxrss/1024.;          // kB
+#endif
+    }
+  }
+#endif
+  return peak;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayResourceUsage::PrintStartup()
+{
+  if ( fStartupPrinted ) return;
+  fStartupPrinted = true;
+
+  G4cout << G4endl << " Startup: " << GetElapsedTime() << " s";
+  auto resident = GetResidentMemory();
+  if ( resident > 0. ) G4cout << ", resident memory " << resident << " MB";
+  auto peak = GetPeakResidentMemory();
+  if ( peak > 0. ) G4cout << " (peak " << peak << " MB)";
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
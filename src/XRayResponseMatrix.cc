@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayResponseMatrix.cc
+/// \brief Implementation of the XRayResponseMatrix class
+
+#include "XRayResponseMatrix.hh"
+#include "XRayResponseMatrixMessenger.hh"
+#include "XRayResponseFormat.hh"
+#include "XRayRunAction.hh"
+
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+#include "G4Timer.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayResponseMatrix::XRayResponseMatrix()
+ : fMessenger(nullptr),
+   fEmin(1.*keV),
+   fEmax(10.*keV),
+   fNofEnergies(91),
+   fFileName("XRay_response.xrrm")
+{
+  fMessenger = new XRayResponseMatrixMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayResponseMatrix::~XRayResponseMatrix()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayResponseMatrix::SetGrid(G4double emin, G4double emax, 
+                                 G4int nofEnergies)
+{
+  fEmin = emin;
+  fEmax = emax;
+  fNofEnergies = nofEnergies;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayResponseMatrix::BeamOn(G4int nofEvents)
+{
+  // The tallies are those of the master run action
+  auto runManager = G4RunManager::GetRunManager();
+  auto runAction 
+    = dynamic_cast<const XRayRunAction*>(runManager->GetUserRunAction());
+  if ( ! runAction || runAction->GetNofTallies() == 0 || nofEvents <= 0 ) {
+    G4ExceptionDescription msg;
+    msg << "No tally to build the response matrix from.";
+    G4Exception("XRayResponseMatrix::BeamOn()",
+      "MyCode0012", JustWarning, msg);
+    return;
+  }
+
+  if ( G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit ) {
+    runManager->Initialize();
+  }
+
+  // Monoenergetic primaries of the gun
+  auto UImanager = G4UImanager::GetUIpointer();
+  for ( auto command : { "/xray/gun/source gun", "/xray/gun/spectrum mono" } ) {
+    auto status = UImanager->ApplyCommand(command);
+    if ( status != fCommandSucceeded ) {
+      G4ExceptionDescription msg;
+      msg << "Command \"" << command << "\" failed (status " << status 
+          << "), the response matrix is not built.";
+      G4Exception("XRayResponseMatrix::BeamOn()",
+        "MyCode0012", JustWarning, msg);
+      return;
+    }
+  }
+
+  const G4int nofTallies = runAction->GetNofTallies();
+  const G4int nofBins = runAction->GetTally(0)->GetNofBins();
+  std::vector<G4double> energies;
+  std::vector<std::vector<G4double>> matrices(nofTallies);
+  std::vector<std::vector<G4double>> errors(nofTallies);
+  std::vector<G4double> means, relErrors;
+
+  G4Timer timer;
+  timer.Start();
+  for ( G4int i=0; i<fNofEnergies; ++i ) {
+    auto energy = ( fNofEnergies > 1 ) 
+      ? fEmin + i*(fEmax - fEmin)/(fNofEnergies - 1) : fEmin;
+    std::ostringstream command;
+    command.precision(10);
+    command << "/gun/energy " << energy/keV << " keV";
+    G4cout << G4endl << "--------------------> Response matrix row " << i 
+           << " of " << fNofEnergies << " : " << command.str() << G4endl;
+    UImanager->ApplyCommand(command.str());
+
+    runManager->BeamOn(nofEvents);
+
+    // One row per tally
+    energies.push_back(energy/keV);
+    for ( G4int id=0; id<nofTallies; ++id ) {
+      runAction->GetTallyMeans(id, means, relErrors);
+      matrices[id].insert(matrices[id].end(), means.begin(), means.end());
+      errors[id].insert(errors[id].end(), relErrors.begin(), relErrors.end());
+    }
+  }
+  timer.Stop();
+
+  // Write the matrices
+  XRayResponseHeader header = {};
+  std::copy_n("XRRM", 4, header.fMagic);
+  header.fVersion = kXRayResponseVersion;
+  header.fNofEnergies = fNofEnergies;
+  header.fNofBins = nofBins;
+  header.fNofMatrices = nofTallies;
+  header.fNofEvents = nofEvents;
+  header.fMin = runAction->GetTally(0)->GetBinLowEdge(0)/keV;
+  header.fMax = runAction->GetTally(0)->GetBinLowEdge(nofBins)/keV;
+
+  std::ofstream file(fFileName, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for ( G4int id=0; id<nofTallies; ++id ) {
+    char name[kXRayResponseNameLength] = {};
+    auto tallyName = runAction->GetTally(id)->GetName();
+    tallyName.copy(name, kXRayResponseNameLength - 1);
+    file.write(name, kXRayResponseNameLength);
+  }
+  file.write(reinterpret_cast<const char*>(energies.data()), 
+             energies.size()*sizeof(G4double));
+  for ( G4int id=0; id<nofTallies; ++id ) {
+    file.write(reinterpret_cast<const char*>(matrices[id].data()), 
+               matrices[id].size()*sizeof(G4double));
+    file.write(reinterpret_cast<const char*>(errors[id].data()), 
+               errors[id].size()*sizeof(G4double));
+  }
+  if ( ! file ) {
+    G4cerr << "Cannot write " << fFileName << G4endl;
+    return;
+  }
+
+  G4cout << G4endl 
+         << "--------------------> Response matrix of " << fNofEnergies 
+         << " energies x " << nofBins << " bins (" << nofTallies 
+         << " tallies) written in " << fFileName << G4endl
+         << " Build time : " << timer.GetRealElapsed() << " s" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
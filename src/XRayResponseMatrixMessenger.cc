@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayResponseMatrixMessenger.cc
+/// \brief Implementation of the XRayResponseMatrixMessenger class
+
+#include "XRayResponseMatrixMessenger.hh"
+#include "XRayResponseMatrix.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayResponseMatrixMessenger::XRayResponseMatrixMessenger(
+                               XRayResponseMatrix* matrix)
+ : G4UImessenger(),
+   fMatrix(matrix)
+{
+  fMatrixDir = new G4UIdirectory("/xray/matrix/");
+  fMatrixDir->SetGuidance("Detector response matrix builder");
+
+  fGridCmd = new G4UIcommand("/xray/matrix/grid",this);
+  fGridCmd->SetGuidance("Set the linear grid of the incident energies:");
+  fGridCmd->SetGuidance("first and last energies, number of energies.");
+  auto eminPrm = new G4UIparameter("emin",'d',false);
+  fGridCmd->SetParameter(eminPrm);
+  auto emaxPrm = new G4UIparameter("emax",'d',false);
+  fGridCmd->SetParameter(emaxPrm);
+  auto nofEnergiesPrm = new G4UIparameter("nofEnergies",'i',false);
+  fGridCmd->SetParameter(nofEnergiesPrm);
+  auto unitPrm = new G4UIparameter("unit",'s',true);
+  unitPrm->SetDefaultUnit("keV");
+  fGridCmd->SetParameter(unitPrm);
+  fGridCmd->SetRange("emin>0. && emax>=emin && nofEnergies>0");
+  fGridCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fGridCmd->SetToBeBroadcasted(false);
+
+  fFileNameCmd = new G4UIcmdWithAString("/xray/matrix/fileName",this);
+  fFileNameCmd->SetGuidance("Set the response matrix file.");
+  fFileNameCmd->SetParameterName("fileName",false);
+  fFileNameCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFileNameCmd->SetToBeBroadcasted(false);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/xray/matrix/beamOn",this);
+  fBeamOnCmd->SetGuidance("Run the given number of events at each energy of the grid");
+  fBeamOnCmd->SetGuidance("and write the response matrix of each tally.");
+  fBeamOnCmd->SetParameterName("nofEvents",false);
+  fBeamOnCmd->SetRange("nofEvents>0");
+  fBeamOnCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayResponseMatrixMessenger::~XRayResponseMatrixMessenger()
+{
+  delete fGridCmd;
+  delete fFileNameCmd;
+  delete fBeamOnCmd;
+  delete fMatrixDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayResponseMatrixMessenger::SetNewValue(G4UIcommand* command, 
+                                              G4String newValue)
+{
+  if ( command == fGridCmd ) {
+    std::istringstream is(newValue);
+    G4double emin, emax;
+    G4int nofEnergies;
+    G4String unit;
+    is >> emin >> emax >> nofEnergies >> unit;
+    fMatrix->SetGrid(emin*G4UIcommand::ValueOf(unit), 
+                     emax*G4UIcommand::ValueOf(unit), nofEnergies);
+  }
+
+  if ( command == fFileNameCmd ) 
+   { fMatrix->SetFileName(newValue); }
+
+  if ( command == fBeamOnCmd ) 
+   { fMatrix->BeamOn(fBeamOnCmd->GetNewIntValue(newValue)); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -29,16 +29,58 @@
 
 #include "XRayRunAction.hh"
 #include "XRayAnalysis.hh"
+#include "XRaySteppingAction.hh"
+#include "XRayPrimaryGeneratorAction.hh"
+#include "XRayStackingAction.hh"
+#include "XRayTopology.hh"
+#include "XRayShard.hh"
+#include "XRayShardFormat.hh"
+#include "XRaySweep.hh"
+#include "XRayResourceUsage.hh"
+#include "XRayPhysicsList.hh"
+#include "XRayDetectorConstruction.hh"
 
 #include "G4Run.hh"
+#include "G4AccumulableManager.hh"
 #include "G4RunManager.hh"
+#include "G4Threading.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 XRayRunAction::XRayRunAction()
- : G4UserRunAction()
+ : G4UserRunAction(),
+   fSteppingAction(nullptr),
+   fPrimaryGenerator(nullptr),
+   fStackingAction(nullptr),
+   fNofSteps(0),
+   fNofSkippedTracks(0),
+   fNofTerminatedEvents(0),
+   fNofCullingTests(0),
+   fNofCulledTracks(0),
+   fGenerationTime(0.),
+   fNofGenerated(0),
+   fNofPrimaries(0),
+   fNofQuasiRandom(0),
+   fNofAdditiveScoring(0),
+   fEventTime(0.),
+   fThreadTime(0.),
+   fNofThreads(0),
+   fThreadStatistics("Threads"),
+   fTargetResponse("TargetResponse"),
+   fOutputSuffix(XRayShard::GetSuffix()),
+   fEventIDOffset(0),
+   fForkedProcess(false),
+   fForkedEvents(0),
+   fForkedRealTime(0.),
+   fLastNofEvents(0),
+   fLastPrimariesPerEvent(1.)
 { 
   // set printing event number per each event
   G4RunManager::GetRunManager()->SetPrintProgress(1);     
@@ -56,12 +98,42 @@ XRayRunAction::XRayRunAction()
   analysisManager->SetNtupleMerging(true);
     // Note: merging ntuples is available only with Root output
 
+  // Register accumulable to the accumulable manager
+  auto accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->RegisterAccumulable(fNofSteps);
+  accumulableManager->RegisterAccumulable(fNofSkippedTracks);
+  accumulableManager->RegisterAccumulable(fNofTerminatedEvents);
+  accumulableManager->RegisterAccumulable(fNofCullingTests);
+  accumulableManager->RegisterAccumulable(fNofCulledTracks);
+  accumulableManager->RegisterAccumulable(fGenerationTime);
+  accumulableManager->RegisterAccumulable(fNofGenerated);
+  accumulableManager->RegisterAccumulable(fNofPrimaries);
+  accumulableManager->RegisterAccumulable(fNofQuasiRandom);
+  accumulableManager->RegisterAccumulable(fNofAdditiveScoring);
+  accumulableManager->RegisterAccumulable(fEventTime);
+  accumulableManager->RegisterAccumulable(fThreadTime);
+  accumulableManager->RegisterAccumulable(fNofThreads);
+  accumulableManager->RegisterAccumulable(fThreadStatistics);
+  accumulableManager->RegisterAccumulable(fTargetResponse);
+
   // Book histograms, ntuple
   //
   
   // Creating histograms
   analysisManager->CreateH1("EDet","Photon Energy Incident on the Detector", 1000, 0., 7.*keV);
   analysisManager->CreateH1("EDetFluo","Photo-Electric Effect Photon Energy Incident on the Detector", 1000, 0., 7.*keV);
+  analysisManager->CreateH1("EDetFluoNEE","Next-Event Estimate of the Photo-Electric Effect Photon Energy Incident on the Detector", 1000, 0., 7.*keV);
+
+  // Creating the thread-local histograms filled by the event action
+  for ( G4int id=0; id<3; ++id ) {
+    fHistograms.push_back(new XRayEnergyHistogram(id));
+  }
+
+  // Creating the weighted tallies with the histograms binning
+  fTallies.push_back(new XRayTally("EDet", 1000, 0., 7.*keV));
+  fTallies.push_back(new XRayTally("EDetFluo", 1000, 0., 7.*keV));
+  fTallies.push_back(new XRayTally("EDetFluoNEE", 1000, 0., 7.*keV));
+  for ( auto tally : fTallies ) accumulableManager->RegisterAccumulable(tally);
   //analysisManager->CreateH1("Egap","Edep in gap", 100, 0., 100*MeV);
   //analysisManager->CreateH1("Labs","trackL in absorber", 100, 0., 1*m);
   //analysisManager->CreateH1("Lgap","trackL in gap", 100, 0., 50*cm);
@@ -82,40 +154,110 @@ XRayRunAction::XRayRunAction()
 
 XRayRunAction::~XRayRunAction()
 {
+  for ( auto histogram : fHistograms ) delete histogram;
+  for ( auto tally : fTallies ) delete tally;
   delete G4AnalysisManager::Instance();  
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void XRayRunAction::BeginOfRunAction(const G4Run* /*run*/)
+void XRayRunAction::BeginOfRunAction(const G4Run* run)
 { 
   //inform the runManager to save random number seed
   //G4RunManager::GetRunManager()->SetRandomNumberStore(true);
+
+  // reset accumulables to their initial values
+  G4AccumulableManager::Instance()->Reset();
+  for ( auto histogram : fHistograms ) histogram->Reset();
+  if ( fSteppingAction ) fSteppingAction->BeginOfRun();
+  if ( fStackingAction ) fStackingAction->BeginOfRun();
+  // the forked processes generated the primaries of a forked run
+  if ( fPrimaryGenerator && fForkedEvents == 0 ) fPrimaryGenerator->BeginOfRun();
+
+  // Book the target response table to build (XRayTargetResponseSD)
+  auto physicsList = dynamic_cast<const XRayPhysicsList*>(
+    G4RunManager::GetRunManager()->GetUserPhysicsList());
+  if ( physicsList && physicsList->GetTargetResponseMode() == "build" ) {
+    fTargetResponse.SetEnergyRange(physicsList->GetTargetResponseEmin(),
+                                   physicsList->GetTargetResponseEmax());
+  }
+
+  // The table to use must have been built for the current target
+  if ( isMaster ) CheckTargetResponse();
+
+  // Event IDs of the shard; the tallies only need them modulo the batches
+  fEventIDOffset = G4int(
+    XRayShard::GetEventIDOffset(run->GetNumberOfEventToBeProcessed()) 
+    % fTallies[0]->GetNofBatches());
   
   // Get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
 
-  // Open an output file
+  // Open an output file; only the master writes the histograms, reduced
+  // from the XRayEnergyHistogram of the workers
   //
-  G4String fileName = "XRay";
-  analysisManager->OpenFile(fileName);
+  G4String fileName = "XRay" + GetRunSuffix();
+  if ( isMaster ) analysisManager->OpenFile(fileName);
+
+  // the physics tables are built: end of the startup
+  if ( isMaster ) XRayResourceUsage::PrintStartup();
+
+  fTimer.Start();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void XRayRunAction::EndOfRunAction(const G4Run* /*run*/)
+void XRayRunAction::EndOfRunAction(const G4Run* run)
 {
-  // print histogram statistics
+  fTimer.Stop();
+
+  // Merge accumulables 
   //
-  auto analysisManager = G4AnalysisManager::Instance();
-  if ( analysisManager->GetH1(0) ) {
-    G4cout << G4endl << " ----> print histograms statistic ";
-    if(isMaster) {
-      G4cout << "for the entire run " << G4endl << G4endl; 
+  if ( fSteppingAction ) fNofSteps += fSteppingAction->GetNofSteps();
+  if ( fPrimaryGenerator && fForkedEvents == 0 ) {
+    fGenerationTime += fPrimaryGenerator->GetGenerationTime();
+    fNofGenerated += fPrimaryGenerator->GetNofGenerated();
+    if ( fPrimaryGenerator->IsQuasiRandom() ) fNofQuasiRandom += 1;
+    if ( fStackingAction && fStackingAction->GetAdditiveScoring() ) {
+      fNofAdditiveScoring += 1;
     }
-    else {
-      G4cout << "for the local thread " << G4endl << G4endl; 
+
+    // this thread processed the events
+    fThreadTime += fTimer.GetRealElapsed();
+    fNofThreads += 1;
+    fThreadStatistics.Fill(G4Threading::G4GetThreadId(), 
+      run->GetNumberOfEvent(), fTimer.GetRealElapsed(), 
+      XRayTopology::GetCurrentCpu());
+  }
+  G4AccumulableManager::Instance()->Merge();
+
+  // Reduce the worker histograms on the master 
+  // and export them to the analysis manager
+  //
+  auto analysisManager = G4AnalysisManager::Instance();
+  if ( isMaster ) {
+    for ( G4int id=0; id<G4int(fHistograms.size()); ++id ) {
+      fHistograms[id]->Reduce();
+      auto h1 = analysisManager->GetH1(id);
+      if ( h1 ) fHistograms[id]->Export(*h1);
     }
+  }
+
+  // the histograms and tallies are normalised per primary
+  auto nofEvents = run->GetNumberOfEvent();
+  if ( fForkedEvents > 0 ) nofEvents = fForkedEvents;
+  G4long nofPrimaries = fNofPrimaries.GetValue();
+  if ( nofPrimaries == 0 ) nofPrimaries = nofEvents;
+  fLastNofEvents = nofEvents;
+  fLastPrimariesPerEvent 
+    = ( nofEvents > 0 ) ? G4double(nofPrimaries)/nofEvents : 1.;
+
+  // print histogram statistics
+  //
+  // (the histograms are only filled on the master)
+  if ( isMaster && analysisManager->GetH1(0) ) {
+    G4cout << G4endl << " ----> print histograms statistic ";
+    G4cout << "for the entire run " << G4endl << G4endl; 
     
     G4cout << " EDet : mean = " 
        << G4BestUnit(analysisManager->GetH1(0)->mean(), "Energy") 
@@ -124,13 +266,371 @@ void XRayRunAction::EndOfRunAction(const G4Run* /*run*/)
     G4cout << " EDetFluo : mean = "
        << G4BestUnit(analysisManager->GetH1(1)->mean(), "Energy")
        << " rms = "
-       << G4BestUnit(analysisManager->GetH1(1)->mean(), "Energy") << G4endl;
+       << G4BestUnit(analysisManager->GetH1(1)->rms(),  "Energy") << G4endl;
+    if ( analysisManager->GetH1(2)->entries() > 0 && nofPrimaries > 0 ) {
+      G4cout << " EDetFluoNEE : mean = "
+         << G4BestUnit(analysisManager->GetH1(2)->mean(), "Energy")
+         << " photons/primary = "
+         << analysisManager->GetH1(2)->sum_bin_heights()/nofPrimaries
+         << G4endl;
+    }
+  }
+
+  // print throughput
+  //
+  auto realTime = fTimer.GetRealElapsed();
+  if ( fForkedEvents > 0 ) realTime = fForkedRealTime;
+  if ( nofEvents > 0 && realTime > 0. ) {
+    G4cout << " Throughput : " << nofEvents/realTime << " events/s";
+    if ( nofPrimaries != nofEvents ) {
+      G4cout << ", " << nofPrimaries/realTime << " primaries/s";
+    }
+    if ( fNofSteps.GetValue() > 0 ) {
+      G4cout << ", " << fNofSteps.GetValue()/realTime << " steps/s";
+    }
+    G4cout << " (" << nofEvents << " events in " << realTime << " s)" << G4endl;
+  }
+  if ( isMaster && fNofThreads.GetValue() > 0 && realTime > 0. ) {
+    // event loops: within and outside of the events, waiting for work
+    auto threadTime = fThreadTime.GetValue();
+    auto eventTime = std::min(fEventTime.GetValue(), threadTime);
+    auto idleTime = std::max(0., fNofThreads.GetValue()*realTime - threadTime);
+    auto totalTime = threadTime + idleTime;
+    G4cout << " Time breakdown (" << fNofThreads.GetValue() << " threads) :"
+           << " events " << eventTime << " s (" 
+           << 100.*eventTime/totalTime << " %),"
+           << " between events " << threadTime - eventTime << " s (" 
+           << 100.*(threadTime - eventTime)/totalTime << " %),"
+           << " idle " << idleTime << " s (" 
+           << 100.*idleTime/totalTime << " %)" << G4endl;
+    if ( fThreadStatistics.GetNofThreads() > 1 ) fThreadStatistics.Print();
+  }
+  if ( fNofGenerated.GetValue() > 0 ) {
+    G4cout << " Primary generation : " 
+           << 1.e9*fGenerationTime.GetValue()/fNofGenerated.GetValue()
+           << " ns/event" << G4endl;
+  }
+  if ( fNofTerminatedEvents.GetValue() > 0 ) {
+    G4cout << " First-hit mode : " << fNofTerminatedEvents.GetValue() 
+           << " events terminated early, " << fNofSkippedTracks.GetValue()
+           << " tracks skipped" << G4endl;
+  }
+  if ( fNofCullingTests.GetValue() > 0 ) {
+    G4cout << " Culling : " << fNofCulledTracks.GetValue() << " of "
+           << fNofCullingTests.GetValue() << " tests culled ("
+           << 100.*fNofCulledTracks.GetValue()/fNofCullingTests.GetValue()
+           << " %, new neutral tracks and photons leaving the target)" 
+           << G4endl;
   }
 
-  // save histograms & ntuple
+  // print and save the tallies with their statistical errors
   //
-  analysisManager->Write();
-  analysisManager->CloseFile();
+  if ( isMaster ) WriteTallies(nofEvents, nofPrimaries, realTime);
+
+  // compare the samplers over the replicated runs
+  //
+  if ( isMaster ) AddReplicate(nofEvents, nofPrimaries);
+
+  // save the values of the shard
+  //
+  if ( isMaster && XRayShard::IsEnabled() && ! fForkedProcess ) {
+    WriteShard(run, nofEvents, realTime);
+  }
+
+  // save the target response table
+  //
+  if ( isMaster ) WriteTargetResponse(run);
+
+  // save histograms & ntuple; the H1 of the workers are left empty,
+  // so that the analysis manager has nothing to merge
+  //
+  if ( isMaster ) {
+    analysisManager->Write();
+    analysisManager->CloseFile();
+  }
+
+  fForkedEvents = 0;
+  fForkedRealTime = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::GetTallyMeans(G4int id, std::vector<G4double>& means,
+                                  std::vector<G4double>& relErrors) const
+{
+  const auto tally = fTallies[id];
+  means.assign(tally->GetNofBins(), 0.);
+  relErrors.assign(tally->GetNofBins(), 0.);
+  if ( fLastNofEvents <= 0 ) return;
+
+  for ( G4int bin=0; bin<tally->GetNofBins(); ++bin ) {
+    tally->ComputeStatistics(bin, fLastNofEvents, means[bin], relErrors[bin]);
+    means[bin] /= fLastPrimariesPerEvent;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::CheckTargetResponse() const
+{
+  auto runManager = G4RunManager::GetRunManager();
+  auto physicsList 
+    = dynamic_cast<const XRayPhysicsList*>(runManager->GetUserPhysicsList());
+  auto detector = dynamic_cast<const XRayDetectorConstruction*>(
+    runManager->GetUserDetectorConstruction());
+  if ( ! physicsList || ! detector ) return;
+
+  auto response = physicsList->GetTargetResponse();
+  if ( ! response || response->IsBuiltFor(detector->GetTargetMaterial(),
+                                          detector->GetTargetThickness()) ) {
+    return;
+  }
+
+  G4ExceptionDescription msg;
+  msg << "The target response " << physicsList->GetTargetResponseFile()
+      << " was built for " << response->GetMaterial() << ", "
+      << G4BestUnit(response->GetThickness(), "Length") << "," << G4endl;
+  msg << "the target is " << detector->GetTargetMaterial() << ", "
+      << G4BestUnit(detector->GetTargetThickness(), "Length") << ".";
+  G4Exception("XRayRunAction::CheckTargetResponse()",
+    "MyCode0011", FatalException, msg);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::WriteTargetResponse(const G4Run* run)
+{
+  auto physicsList = dynamic_cast<const XRayPhysicsList*>(
+    G4RunManager::GetRunManager()->GetUserPhysicsList());
+  if ( ! physicsList || physicsList->GetTargetResponseMode() != "build" ||
+       fTargetResponse.GetNofIncident() <= 0. ) return;
+
+  // the table holds for the target of the run
+  auto detector = dynamic_cast<const XRayDetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if ( detector ) {
+    fTargetResponse.SetTarget(detector->GetTargetMaterial(),
+                              detector->GetTargetThickness());
+  }
+
+  // the suffix and the ID of the run go before the extension, a table
+  // per run
+  G4String fileName = physicsList->GetTargetResponseFile();
+  auto dot = fileName.rfind('.');
+  if ( dot == std::string::npos ) dot = fileName.size();
+  std::ostringstream suffix;
+  suffix << GetRunSuffix() << "_run" << run->GetRunID();
+  fileName.insert(dot, suffix.str());
+
+  if ( fTargetResponse.Write(fileName) ) {
+    G4cout << " Target response : " << fTargetResponse.GetNofIncident()
+           << " incident photons written in " << fileName << G4endl;
+  } 
+  else {
+    G4cerr << "Cannot write " << fileName << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::WriteTallies(G4int nofEvents, G4long nofPrimaries,
+                                 G4double realTime) const
+{
+  if ( nofEvents <= 0 || nofPrimaries <= 0 ) return;
+
+  // the batches are made of events, the means are given per primary
+  G4double primariesPerEvent = G4double(nofPrimaries)/nofEvents;
+
+  // the detector tallies score the first photon of each primary, or all
+  // the photons with their weights (/xray/scoring)
+  G4String scoring = fNofAdditiveScoring.GetValue() > 0 ? "all" : "first";
+
+  G4cout << G4endl << " ----> tallies per primary (batch means over " 
+         << fTallies[0]->GetNofBatches() << " batches, scoring " << scoring
+         << ") " << G4endl << G4endl;
+  for ( auto tally : fTallies ) {
+    G4double mean, relError;
+    tally->ComputeStatistics(-1, nofEvents, mean, relError);
+    mean /= primariesPerEvent;
+    G4cout << " " << tally->GetName() << " : " << mean 
+           << " +- " << 100.*relError << " %";
+    if ( relError > 0. && realTime > 0. ) {
+      G4cout << " FOM = " << 1./(relError*relError*realTime) << " /s";
+    }
+    G4cout << G4endl;
+  }
+
+  G4String fileName = "XRay_tallies" + GetRunSuffix() + ".csv";
+  std::ofstream file(fileName);
+  if ( ! file ) {
+    G4cerr << "Cannot open " << fileName << G4endl;
+    return;
+  }
+
+  file << "# events " << nofEvents << ", primaries " << nofPrimaries 
+       << ", real time " << realTime << " s, scoring " << scoring << "\n";
+  file << "tally,bin,low [keV],high [keV],mean,relError,FOM [1/s]" << "\n";
+  for ( auto tally : fTallies ) {
+    for ( G4int bin=-1; bin<tally->GetNofBins(); ++bin ) {
+      G4double mean, relError;
+      tally->ComputeStatistics(bin, nofEvents, mean, relError);
+      mean /= primariesPerEvent;
+      G4double fom = 0.;
+      if ( relError > 0. && realTime > 0. ) fom = 1./(relError*relError*realTime);
+      // bin -1 is the whole tally
+      auto low  = tally->GetBinLowEdge(bin < 0 ? 0 : bin);
+      auto high = tally->GetBinLowEdge(bin < 0 ? tally->GetNofBins() : bin + 1);
+      file << tally->GetName() << "," << bin << ","
+           << low/keV << "," << high/keV << ","
+           << mean << "," << relError << "," << fom << "\n";
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::AddReplicate(G4int nofEvents, G4long nofPrimaries)
+{
+  if ( nofEvents <= 0 || nofPrimaries <= 0 ) return;
+
+  G4double primariesPerEvent = G4double(nofPrimaries)/nofEvents;
+
+  std::vector<std::vector<G4double>> means;
+  std::vector<G4String> names;
+  for ( auto tally : fTallies ) {
+    std::vector<G4double> bins(tally->GetNofBins());
+    for ( G4int bin=0; bin<tally->GetNofBins(); ++bin ) {
+      G4double relError;
+      tally->ComputeStatistics(bin, nofEvents, bins[bin], relError);
+      bins[bin] /= primariesPerEvent;
+    }
+    means.push_back(bins);
+    names.push_back(tally->GetName());
+  }
+
+  G4String sampler = fNofQuasiRandom.GetValue() > 0 ? "sobol" : "pseudo";
+  fReplicates.AddRun(sampler, nofEvents, means);
+  fReplicates.Write(names, "XRay_samplers" + GetRunSuffix() + ".csv");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t XRayRunAction::GetProcessDataSize() const
+{
+  std::size_t size = kXRayShardNofCounters;
+  for ( auto histogram : fHistograms ) size += histogram->GetDataSize();
+  for ( auto tally : fTallies ) size += tally->GetDataSize();
+  return size;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::ExportProcessData(G4double* data) const
+{
+  // The counters are exact as doubles up to 2^53
+  *data++ = fNofPrimaries.GetValue();
+  *data++ = fNofSteps.GetValue();
+  *data++ = fNofSkippedTracks.GetValue();
+  *data++ = fNofTerminatedEvents.GetValue();
+  *data++ = fNofCullingTests.GetValue();
+  *data++ = fNofCulledTracks.GetValue();
+  *data++ = fGenerationTime.GetValue();
+  *data++ = fNofGenerated.GetValue();
+  *data++ = fNofQuasiRandom.GetValue();
+  *data++ = fNofAdditiveScoring.GetValue();
+  for ( auto histogram : fHistograms ) {
+    histogram->CopyTo(data);
+    data += histogram->GetDataSize();
+  }
+  for ( auto tally : fTallies ) {
+    tally->CopyTo(data);
+    data += tally->GetDataSize();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::ImportProcessData(const G4double* data)
+{
+  fNofPrimaries += G4long(*data++);
+  fNofSteps += G4long(*data++);
+  fNofSkippedTracks += G4long(*data++);
+  fNofTerminatedEvents += G4long(*data++);
+  fNofCullingTests += G4long(*data++);
+  fNofCulledTracks += G4long(*data++);
+  fGenerationTime += *data++;
+  fNofGenerated += G4long(*data++);
+  fNofQuasiRandom += G4int(*data++);
+  fNofAdditiveScoring += G4int(*data++);
+  for ( auto histogram : fHistograms ) {
+    histogram->Add(data);
+    data += histogram->GetDataSize();
+  }
+  for ( auto tally : fTallies ) {
+    tally->Add(data);
+    data += tally->GetDataSize();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayRunAction::WriteShard(const G4Run* run, G4int nofEvents,
+                               G4double realTime) const
+{
+  XRayShardHeader header;
+  std::memcpy(header.fMagic, "XRSH", 4);
+  header.fVersion = kXRayShardVersion;
+  header.fShard = XRayShard::GetIndex();
+  header.fNofShards = XRayShard::GetNofShards();
+  header.fConfigHash = XRayShard::ComputeConfigHash();
+  header.fSeeds[0] = XRayShard::GetSeeds()[0];
+  header.fSeeds[1] = XRayShard::GetSeeds()[1];
+  header.fNofEvents = nofEvents;
+  header.fFirstEventID 
+    = XRayShard::GetEventIDOffset(run->GetNumberOfEventToBeProcessed());
+  header.fNofMerged = 1;
+  header.fNofHistograms = fHistograms.size();
+  header.fNofHistogramBins = XRayEnergyHistogram::kNofBins;
+  header.fNofTallies = fTallies.size();
+  header.fNofTallyBins = fTallies[0]->GetNofBins();
+  header.fNofBatches = fTallies[0]->GetNofBatches();
+  header.fMin = XRayEnergyAxis::Min()/keV;
+  header.fMax = XRayEnergyAxis::Max()/keV;
+  header.fRealTime = realTime;
+  header.fNofValues = GetProcessDataSize();
+
+  std::vector<G4double> values(header.fNofValues);
+  ExportProcessData(values.data());
+
+  std::ostringstream fileName;
+  fileName << "XRay" << GetRunSuffix() << "_run" << run->GetRunID() << ".xrsh";
+  std::ofstream file(fileName.str(), std::ios::binary);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for ( auto tally : fTallies ) {
+    char name[kXRayShardNameLength] = { 0 };
+    tally->GetName().copy(name, kXRayShardNameLength - 1);
+    file.write(name, kXRayShardNameLength);
+  }
+  file.write(reinterpret_cast<const char*>(values.data()), 
+             values.size()*sizeof(G4double));
+  if ( ! file ) {
+    G4cerr << "Cannot write " << fileName.str() << G4endl;
+    return;
+  }
+
+  G4cout << " Shard " << header.fShard << " of " << header.fNofShards
+         << " written to " << fileName.str() << " (events " 
+         << header.fFirstEventID << " - " 
+         << header.fFirstEventID + nofEvents - 1 << ", configuration "
+         << std::hex << header.fConfigHash << std::dec << ")" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String XRayRunAction::GetRunSuffix() const
+{
+  // the process or shard suffix, then the point of a sweep
+  return fOutputSuffix + XRaySweep::GetLabel();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,90 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayShard.cc
+/// \brief Implementation of the XRayShard class
+
+#include "XRayShard.hh"
+
+#include "G4UImanager.hh"
+#include "Randomize.hh"
+
+#include <limits>
+#include <sstream>
+
+G4int XRayShard::fIndex = 0;
+G4int XRayShard::fNofShards = 0;
+long  XRayShard::fSeeds[3] = { 0, 0, 0 };
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayShard::Configure(G4int index, G4int nofShards)
+{
+  fIndex = index;
+  fNofShards = nofShards;
+  fSeeds[0] = index + 1;
+  fSeeds[1] = nofShards;
+  fSeeds[2] = 0;
+  G4Random::setTheSeeds(fSeeds);
+
+  // Keep all the commands of the session for the configuration hash,
+  // the UI manager keeps only the last 20 by default
+  G4UImanager::GetUIpointer()->SetMaxHistSize(std::numeric_limits<G4int>::max());
+
+  G4cout << "Shard " << index << " of " << nofShards 
+         << ", seeds " << fSeeds[0] << " " << fSeeds[1] << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String XRayShard::GetSuffix()
+{
+  if ( ! IsEnabled() ) return "";
+  std::ostringstream suffix;
+  suffix << "_shard" << fIndex;
+  return suffix.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint64_t XRayShard::ComputeConfigHash()
+{
+  // FNV-1a over the command history, from the start of the session
+  std::uint64_t hash = 14695981039346656037ull;
+  auto UImanager = G4UImanager::GetUIpointer();
+  for ( G4int i=0; i<UImanager->GetNumberOfHistory(); ++i ) {
+    G4String command = UImanager->GetPreviousCommand(i);
+    for ( auto character : command ) {
+      hash ^= std::uint8_t(character);
+      hash *= 1099511628211ull;
+    }
+    hash ^= std::uint8_t('\n');
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,148 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRaySobol.cc
+/// \brief Implementation of the XRaySobol class
+
+#include "XRaySobol.hh"
+
+#include <random>
+
+namespace {
+
+  // Joe-Kuo direction numbers (new-joe-kuo-6.21201) of the dimensions 
+  // 2 - 6: degree s, coefficients a and initial numbers m of the 
+  // primitive polynomial; the first dimension is the van der Corput one
+  struct Polynomial { G4int s; G4int a; G4int m[4]; };
+  const Polynomial kPolynomials[XRaySobol::kNofDimensions - 1] = {
+    { 1, 0, { 1, 0, 0, 0 } },
+    { 2, 1, { 1, 3, 0, 0 } },
+    { 3, 1, { 1, 3, 1, 0 } },
+    { 3, 2, { 1, 1, 1, 0 } },
+    { 4, 1, { 1, 1, 3, 3 } }
+  };
+
+  G4int Parity(std::uint32_t value)
+  {
+    value ^= value >> 16;
+    value ^= value >> 8;
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+    return value & 1u;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySobol::XRaySobol()
+ : fIndex(0)
+{
+  Scramble(0, -1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySobol::~XRaySobol()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySobol::Scramble(G4long seed, G4int runID)
+{
+  // Unscrambled direction numbers
+  for ( G4int k=0; k<kNofBits; ++k ) {
+    fDirections[0][k] = 1u << (kNofBits - 1 - k);
+  }
+  for ( G4int d=1; d<kNofDimensions; ++d ) {
+    const auto& polynomial = kPolynomials[d - 1];
+    const auto s = polynomial.s;
+    auto v = fDirections[d];
+    for ( G4int k=0; k<kNofBits; ++k ) {
+      if ( k < s ) {
+        v[k] = std::uint32_t(polynomial.m[k]) << (kNofBits - 1 - k);
+        continue;
+      }
+      v[k] = v[k - s] ^ (v[k - s] >> s);
+      for ( G4int l=1; l<s; ++l ) {
+        if ( (polynomial.a >> (s - 1 - l)) & 1 ) v[k] ^= v[k - l];
+      }
+    }
+  }
+
+  // The run -1 is the unscrambled sequence
+  if ( runID < 0 ) {
+    for ( G4int d=0; d<kNofDimensions; ++d ) fShift[d] = 0;
+    Skip(0);
+    return;
+  }
+
+  // Private generator: the scrambling must be the same on all threads
+  std::seed_seq sequence{ std::uint32_t(seed), std::uint32_t(seed >> 32),
+                          std::uint32_t(runID) };
+  std::mt19937 engine(sequence);
+
+  for ( G4int d=0; d<kNofDimensions; ++d ) {
+    // Random lower triangular matrix with a unit diagonal, the row i
+    // giving the bit i (from the most significant one) of the result
+    std::uint32_t rows[kNofBits];
+    for ( G4int i=0; i<kNofBits; ++i ) {
+      std::uint32_t diagonal = 1u << (kNofBits - 1 - i);
+      std::uint32_t above = ~(2*diagonal - 1);  // the more significant bits
+      rows[i] = (std::uint32_t(engine()) & above) | diagonal;
+    }
+    for ( G4int k=0; k<kNofBits; ++k ) {
+      std::uint32_t scrambled = 0;
+      for ( G4int i=0; i<kNofBits; ++i ) {
+        if ( Parity(rows[i] & fDirections[d][k]) ) {
+          scrambled |= 1u << (kNofBits - 1 - i);
+        }
+      }
+      fDirections[d][k] = scrambled;
+    }
+    fShift[d] = std::uint32_t(engine());
+  }
+
+  Skip(0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySobol::Skip(std::uint32_t index)
+{
+  // The point n is the sum of the direction numbers 
+  // of the bits of the Gray code of n
+  auto gray = index ^ (index >> 1);
+  for ( G4int d=0; d<kNofDimensions; ++d ) {
+    fState[d] = 0;
+    for ( G4int k=0; k<kNofBits; ++k ) {
+      if ( (gray >> k) & 1u ) fState[d] ^= fDirections[d][k];
+    }
+  }
+  fIndex = index;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
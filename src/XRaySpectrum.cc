@@ -0,0 +1,215 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRaySpectrum.cc
+/// \brief Implementation of the XRaySpectrum class
+
+#include "XRaySpectrum.hh"
+#include "XRaySpectrumFormat.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+
+namespace {
+
+// Characteristic lines of the tube anodes, energies in keV
+struct XRayAnodeLine
+{
+  const char* fAnode;
+  G4int    fZ;
+  G4double fEnergy;   // line energy
+  G4double fEdge;     // ionisation edge of the shell
+  G4double fFraction; // fraction of the shell emission in the line
+};
+
+const XRayAnodeLine kAnodeLines[] = {
+  { "Ti", 22,  4.511,  4.966, 0.88 }, { "Ti", 22,  4.932,  4.966, 0.12 },
+  { "Cr", 24,  5.415,  5.989, 0.88 }, { "Cr", 24,  5.947,  5.989, 0.12 },
+  { "Cu", 29,  8.048,  8.979, 0.87 }, { "Cu", 29,  8.905,  8.979, 0.13 },
+  { "Mo", 42, 17.479, 20.000, 0.84 }, { "Mo", 42, 19.608, 20.000, 0.16 },
+  { "Rh", 45, 20.216, 23.220, 0.83 }, { "Rh", 45, 22.724, 23.220, 0.17 },
+  { "Ag", 47, 22.163, 25.514, 0.83 }, { "Ag", 47, 24.942, 25.514, 0.17 },
+  { "W",  74,  8.398, 10.207, 0.60 }, { "W",  74,  9.672, 11.544, 0.40 },
+  { "W",  74, 59.318, 69.525, 0.80 }, { "W",  74, 67.244, 69.525, 0.20 }
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySpectrum::XRaySpectrum()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySpectrum::~XRaySpectrum()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySpectrum::Clear()
+{
+  fLow.clear();
+  fWidth.clear();
+  fIntensity.clear();
+  fProbability.clear();
+  fAlias.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySpectrum::AddBin(G4double low, G4double high, G4double intensity)
+{
+  // written so as to also skip the NaN values
+  if ( ! (intensity > 0.) || ! (high >= low) || ! (low >= 0.) 
+       || ! std::isfinite(high) || ! std::isfinite(intensity) ) return;
+
+  fLow.push_back(low);
+  fWidth.push_back(high - low);
+  fIntensity.push_back(intensity);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRaySpectrum::LoadFile(const G4String& fileName)
+{
+  Clear();
+
+  std::vector<XRaySpectrumBin> bins;
+  std::string error;
+  if ( ReadXRaySpectrum(fileName, bins, error) ) {
+    for ( const auto& bin : bins ) {
+      AddBin(bin.fLow*keV, bin.fHigh*keV, bin.fIntensity);
+    }
+    if ( fIntensity.empty() ) error = "no bin of positive intensity";
+  }
+
+  if ( fIntensity.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read a spectrum from " << fileName << ": " << error;
+    G4Exception("XRaySpectrum::LoadFile()", "MyCode0003", JustWarning, msg);
+    Clear();
+    return false;
+  }
+
+  Prepare();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRaySpectrum::BuildTube(G4double voltage, const G4String& anode)
+{
+  Clear();
+
+  G4int z = 0;
+  for ( const auto& line : kAnodeLines ) {
+    if ( anode == line.fAnode ) z = line.fZ;
+  }
+
+  const G4double maxEnergy = voltage/kilovolt; // in keV
+  const G4double minEnergy = 1.;               // in keV
+  if ( z == 0 || maxEnergy <= minEnergy ) {
+    G4ExceptionDescription msg;
+    msg << "No tube model for the anode " << anode 
+        << " at " << maxEnergy << " kV";
+    G4Exception("XRaySpectrum::BuildTube()", "MyCode0003", JustWarning, msg);
+    return false;
+  }
+
+  // Kramers' continuum, dN/dE ~ Z (E0/E - 1), integrated in each bin
+  const G4int nofBins = 500;
+  const G4double width = (maxEnergy - minEnergy)/nofBins;
+  for ( G4int i=0; i<nofBins; ++i ) {
+    auto low  = minEnergy + i*width;
+    auto high = low + width;
+    auto intensity = z*(maxEnergy*std::log(high/low) - width);
+    AddBin(low*keV, high*keV, intensity);
+  }
+
+  // Characteristic lines, on the same scale: Z Edge (U-1)^1.63
+  for ( const auto& line : kAnodeLines ) {
+    if ( anode != line.fAnode || maxEnergy <= line.fEdge ) continue;
+    auto overvoltage = maxEnergy/line.fEdge;
+    auto intensity 
+      = z*line.fEdge*std::pow(overvoltage - 1., 1.63)*line.fFraction;
+    AddBin(line.fEnergy*keV, line.fEnergy*keV, intensity);
+  }
+
+  Prepare();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySpectrum::Prepare()
+{
+  const G4int nofBins = fIntensity.size();
+  fProbability.assign(nofBins, 1.);
+  fAlias.resize(nofBins);
+  if ( nofBins == 0 ) return;
+
+  G4double sum = 0.;
+  for ( auto intensity : fIntensity ) sum += intensity;
+
+  // Vose's alias method: split the bins around the mean probability
+  std::vector<G4double> scaled(nofBins);
+  std::vector<G4int> small, large;
+  for ( G4int i=0; i<nofBins; ++i ) {
+    fAlias[i] = i;
+    scaled[i] = fIntensity[i]*nofBins/sum;
+    if ( scaled[i] < 1. ) small.push_back(i);
+    else large.push_back(i);
+  }
+  while ( ! small.empty() && ! large.empty() ) {
+    auto less = small.back();
+    small.pop_back();
+    auto more = large.back();
+    large.pop_back();
+    fProbability[less] = scaled[less];
+    fAlias[less] = more;
+    scaled[more] += scaled[less] - 1.;
+    if ( scaled[more] < 1. ) small.push_back(more);
+    else large.push_back(more);
+  }
+  // The remaining bins are full, up to rounding errors
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRaySpectrum::GetMeanEnergy() const
+{
+  G4double sum = 0.;
+  G4double sumEnergy = 0.;
+  for ( std::size_t i=0; i<fIntensity.size(); ++i ) {
+    sum += fIntensity[i];
+    sumEnergy += fIntensity[i]*(fLow[i] + 0.5*fWidth[i]);
+  }
+  return ( sum > 0. ) ? sumEnergy/sum : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
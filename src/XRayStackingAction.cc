@@ -0,0 +1,239 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayStackingAction.cc
+/// \brief Implementation of the XRayStackingAction class
+
+#include "XRayStackingAction.hh"
+#include "XRayStackingMessenger.hh"
+#include "XRayRunAction.hh"
+#include "XRayEventAction.hh"
+#include "XRayDetectorConstruction.hh"
+#include "XRayNextEventEstimator.hh"
+#include "XRayFluoBiasing.hh"
+#include "XRayCulling.hh"
+#include "XRayPhysicsList.hh"
+
+#include "G4StackManager.hh"
+#include "G4RunManager.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Gamma.hh"
+#include "G4VProcess.hh"
+#include "G4ProcessTable.hh"
+#include "G4EmProcessSubType.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayStackingAction::XRayStackingAction(
+                      const XRayDetectorConstruction* detConstruction,
+                      XRayRunAction* runAction,
+                      XRayEventAction* eventAction)
+ : G4UserStackingAction(),
+   fDetConstruction(detConstruction),
+   fRunAction(runAction),
+   fEventAction(eventAction),
+   fEstimator(nullptr),
+   fMessenger(nullptr),
+   fFirstHitMode(false),
+   fEventDiscarded(false),
+   fCulling(false),
+   fCullingMargin(0.),
+   fCullingInTarget(false),
+   fNextEvent(false),
+   fNextEventKillAnalog(false),
+   fPhotSubType(-1),
+   fFluoBiasing(0.),
+   fAdditiveScoring(false)
+{
+  fEstimator = new XRayNextEventEstimator(detConstruction);
+  fMessenger = new XRayStackingMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayStackingAction::~XRayStackingAction()
+{
+  delete fEstimator;
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack 
+XRayStackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  // Record the primary of the track for the per-primary tallies
+  fEventAction->RegisterTrack(track);
+
+  // Nothing can change the tallies of a terminated event
+  if ( fEventDiscarded ) {
+    fRunAction->AddSkippedTracks(1);
+    return fKill;
+  }
+
+  // Next-event estimate of the fluorescence photons from the target
+  if ( fNextEvent && IsTargetFluorescence(track) ) {
+    auto energy = track->GetKineticEnergy();
+    auto probability = fEstimator->Estimate(track->GetPosition(), energy);
+    fEventAction->AddDetFluoNEE(energy, track->GetWeight()*probability);
+    if ( fNextEventKillAnalog ) return fKill;
+  }
+
+  // The fluorescence photons from the target are emitted again toward the
+  // detector by XRayFluoBiasing, their direction is not final yet
+  if ( fFluoBiasing > 0. && IsTargetFluorescence(track) ) return fUrgent;
+
+  // Geometric acceptance of the neutral tracks
+  if ( fCulling && track->GetDefinition()->GetPDGCharge() == 0. ) {
+    auto culled = IsCulled(track);
+    fRunAction->CountCullingTest(culled);
+    if ( culled ) return fKill;
+  }
+
+  return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayStackingAction::IsCulled(const G4Track* track) const
+{
+  const auto& position = track->GetPosition();
+  const auto& direction = track->GetMomentumDirection();
+
+  if ( fDetectorBox.IsHitBy(position, direction) ) return false;
+
+  if ( fTargetBox.Contains(position) ) return fCullingInTarget;
+
+  // The track may still interact in the target on its way
+  return ! fTargetBox.IsHitBy(position, direction);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayStackingAction::IsTargetFluorescence(const G4Track* track) const
+{
+  if ( track->GetDefinition() != G4Gamma::Gamma() ) return false;
+
+  auto creator = track->GetCreatorProcess();
+  if ( ! creator || creator->GetProcessSubType() != fPhotSubType ) return false;
+
+  return fTargetBox.Contains(track->GetPosition());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayStackingAction::BeginOfRun()
+{
+  // The fluorescence biasing is a physics list option
+  auto physicsList = dynamic_cast<const XRayPhysicsList*>(
+    G4RunManager::GetRunManager()->GetUserPhysicsList());
+  fFluoBiasing = physicsList ? physicsList->GetFluoBiasing() : 0.;
+
+  // The geometry may change between runs, not within a run
+  if ( fCulling || fNextEvent || fFluoBiasing > 0. ) {
+    fTargetBox.Set(fDetConstruction->GetTargetPV());
+    fDetectorBox.Set(fDetConstruction->GetDetectorPV(), fCullingMargin);
+  }
+
+  // Resolve the photo-electric process once
+  if ( ( fNextEvent || fFluoBiasing > 0. ) && fPhotSubType < 0 ) {
+    auto phot = G4ProcessTable::GetProcessTable()->FindProcess("phot", "gamma");
+    fPhotSubType = phot ? phot->GetProcessSubType() : G4int(fPhotoElectricEffect);
+  }
+
+  // The emission of the fluorescence is biased by a process of the gamma
+  auto fluoBiasing = dynamic_cast<XRayFluoBiasing*>(
+    G4ProcessTable::GetProcessTable()->FindProcess("fluoBiasing", "gamma"));
+  if ( fluoBiasing ) {
+    fluoBiasing->Configure(fFluoBiasing, fPhotSubType,
+      fDetConstruction->GetTargetPV(), fDetConstruction->GetDetectorPV());
+  }
+
+  // The photons leaving the target are culled by a process of the gamma
+  auto culling = dynamic_cast<XRayCulling*>(
+    G4ProcessTable::GetProcessTable()->FindProcess("culling", "gamma"));
+  if ( culling ) {
+    culling->Configure(fCulling, fDetConstruction->GetTargetPV(), 
+      fDetectorBox, fRunAction);
+  }
+
+  // The weighted photons of the biasing, and the weighted uncollided and
+  // collided pairs of the forced collision, must all be scored: the first 
+  // photon of a primary alone would give a biased tally
+  auto biasing = ( fFluoBiasing > 0. ) 
+    || ( physicsList && physicsList->GetForceCollision() );
+  if ( biasing && ! fAdditiveScoring ) {
+    G4ExceptionDescription msg;
+    msg << "The fluorescence biasing and the forced collision require" << G4endl;
+    msg << "the scoring of all the photons: use /xray/scoring all.";
+    G4Exception("XRayStackingAction::BeginOfRun()",
+      "MyCode0013", FatalException, msg);
+  }
+  fEventAction->SetAdditiveScoring(fAdditiveScoring);
+  if ( fAdditiveScoring && fFirstHitMode ) {
+    G4ExceptionDescription msg;
+    msg << "The first-hit mode is not compatible with the scoring of all" << G4endl;
+    msg << "the photons, it is disabled in this run.";
+    G4Exception("XRayStackingAction::BeginOfRun()",
+      "MyCode0013", JustWarning, msg);
+  }
+
+  // The estimator counts all the fluorescence photons of a primary,
+  // the analog tally in the "first" mode only the first one
+  if ( fNextEvent && ! fAdditiveScoring ) {
+    G4ExceptionDescription msg;
+    msg << "EDetFluoNEE estimates all the fluorescence photons, EDetFluo" << G4endl;
+    msg << "only the first one of each primary: compare them with /xray/scoring all.";
+    G4Exception("XRayStackingAction::BeginOfRun()",
+      "MyCode0013", JustWarning, msg);
+  }
+
+  if ( fNextEvent ) fEstimator->Prepare();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayStackingAction::PrepareNewEvent()
+{
+  fEventDiscarded = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayStackingAction::DiscardEvent()
+{
+  if ( ! GetFirstHitMode() || fEventDiscarded ) return;
+
+  fEventDiscarded = true;
+  fRunAction->CountTerminatedEvent();
+
+  // Drop the tracks waiting in the stacks
+  fRunAction->AddSkippedTracks(stackManager->GetNTotalTrack());
+  stackManager->clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
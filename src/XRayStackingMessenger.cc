@@ -0,0 +1,150 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayStackingMessenger.cc
+/// \brief Implementation of the XRayStackingMessenger class
+
+#include "XRayStackingMessenger.hh"
+#include "XRayStackingAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayStackingMessenger::XRayStackingMessenger(XRayStackingAction* stackingAction)
+ : G4UImessenger(),
+   fStackingAction(stackingAction)
+{
+  fXRayDir = new G4UIdirectory("/xray/");
+  fXRayDir->SetGuidance("XRay example commands");
+
+  fFirstHitCmd = new G4UIcmdWithABool("/xray/firstHit",this);
+  fFirstHitCmd->SetGuidance("Terminate the event once all detector tallies are filled.");
+  fFirstHitCmd->SetGuidance("Only effective with the sensitive detector scoring.");
+  fFirstHitCmd->SetParameterName("firstHit",true);
+  fFirstHitCmd->SetDefaultValue(true);
+  fFirstHitCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fScoringCmd = new G4UIcmdWithAString("/xray/scoring",this);
+  fScoringCmd->SetGuidance("Select the scoring of the detector tallies:");
+  fScoringCmd->SetGuidance("  first : the first photon of each primary (default)");
+  fScoringCmd->SetGuidance("  all   : all the photons, with their weights");
+  fScoringCmd->SetGuidance("The biasing (/phys/fluoBiasing, /phys/forceCollision)");
+  fScoringCmd->SetGuidance("requires the scoring of all the photons.");
+  fScoringCmd->SetParameterName("scoring",false);
+  fScoringCmd->SetCandidates("first all");
+  fScoringCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCullDir = new G4UIdirectory("/xray/cull/");
+  fCullDir->SetGuidance("Geometric culling of the photons missing the detector");
+
+  fCullCmd = new G4UIcmdWithABool("/xray/cull/active",this);
+  fCullCmd->SetGuidance("Kill the neutral tracks whose straight line misses");
+  fCullCmd->SetGuidance("the detector (and the target, if starting outside it),");
+  fCullCmd->SetGuidance("and the photons leaving the target which miss the detector.");
+  fCullCmd->SetParameterName("cull",true);
+  fCullCmd->SetDefaultValue(true);
+  fCullCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCullMarginCmd = new G4UIcmdWithADoubleAndUnit("/xray/cull/margin",this);
+  fCullMarginCmd->SetGuidance("Set the margin added to the detector bounding box.");
+  fCullMarginCmd->SetParameterName("margin",false);
+  fCullMarginCmd->SetUnitCategory("Length");
+  fCullMarginCmd->SetRange("margin>=0.");
+  fCullMarginCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCullInTargetCmd = new G4UIcmdWithABool("/xray/cull/inTarget",this);
+  fCullInTargetCmd->SetGuidance("Cull also the tracks starting in the target,");
+  fCullInTargetCmd->SetGuidance("neglecting their further interactions in it.");
+  fCullInTargetCmd->SetParameterName("inTarget",true);
+  fCullInTargetCmd->SetDefaultValue(true);
+  fCullInTargetCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fNeeDir = new G4UIdirectory("/xray/nee/");
+  fNeeDir->SetGuidance("Next-event estimator of the fluorescence photons");
+
+  fNeeCmd = new G4UIcmdWithABool("/xray/nee/active",this);
+  fNeeCmd->SetGuidance("Score the probability of each fluorescence photon");
+  fNeeCmd->SetGuidance("created in the target to reach the detector (EDetFluoNEE).");
+  fNeeCmd->SetGuidance("All the photons are scored: compare with the EDetFluo");
+  fNeeCmd->SetGuidance("tally of /xray/scoring all.");
+  fNeeCmd->SetParameterName("nee",true);
+  fNeeCmd->SetDefaultValue(true);
+  fNeeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fNeeKillCmd = new G4UIcmdWithABool("/xray/nee/killAnalog",this);
+  fNeeKillCmd->SetGuidance("Kill the estimated photons instead of tracking them.");
+  fNeeKillCmd->SetParameterName("kill",true);
+  fNeeKillCmd->SetDefaultValue(true);
+  fNeeKillCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayStackingMessenger::~XRayStackingMessenger()
+{
+  delete fFirstHitCmd;
+  delete fScoringCmd;
+  delete fCullCmd;
+  delete fCullMarginCmd;
+  delete fCullInTargetCmd;
+  delete fCullDir;
+  delete fNeeCmd;
+  delete fNeeKillCmd;
+  delete fNeeDir;
+  delete fXRayDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayStackingMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fFirstHitCmd ) 
+   { fStackingAction->SetFirstHitMode(fFirstHitCmd->GetNewBoolValue(newValue)); }
+
+  if ( command == fScoringCmd ) 
+   { fStackingAction->SetScoringMode(newValue); }
+
+  if ( command == fCullCmd ) 
+   { fStackingAction->SetCulling(fCullCmd->GetNewBoolValue(newValue)); }
+
+  if ( command == fCullMarginCmd ) 
+   { fStackingAction->SetCullingMargin(fCullMarginCmd->GetNewDoubleValue(newValue)); }
+
+  if ( command == fCullInTargetCmd ) 
+   { fStackingAction->SetCullingInTarget(fCullInTargetCmd->GetNewBoolValue(newValue)); }
+
+  if ( command == fNeeCmd ) 
+   { fStackingAction->SetNextEvent(fNeeCmd->GetNewBoolValue(newValue)); }
+
+  if ( command == fNeeKillCmd ) 
+   { fStackingAction->SetNextEventKillAnalog(fNeeKillCmd->GetNewBoolValue(newValue)); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
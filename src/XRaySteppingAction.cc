@@ -30,10 +30,13 @@
 #include "XRaySteppingAction.hh"
 #include "XRayEventAction.hh"
 #include "XRayDetectorConstruction.hh"
+#include "XRayScorers.hh"
+#include "XRayTargetResponseModel.hh"
 
 #include "G4Step.hh"
 #include "G4VProcess.hh"
-#include "G4RunManager.hh"
+#include "G4ProcessTable.hh"
+#include "G4EmProcessSubType.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -42,7 +45,10 @@ XRaySteppingAction::XRaySteppingAction(
                       XRayEventAction* eventAction)
   : G4UserSteppingAction(),
     fDetConstruction(detectorConstruction),
-    fEventAction(eventAction)
+    fEventAction(eventAction),
+    fDetectorPV(nullptr),
+    fPhotSubType(fPhotoElectricEffect),
+    fNofSteps(0)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -52,39 +58,39 @@ XRaySteppingAction::~XRaySteppingAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void XRaySteppingAction::BeginOfRun()
+{
+  // The geometry may have been rebuilt since the previous run
+  fDetectorPV = fDetConstruction->GetDetectorPV();
+
+  // Resolve the photo-electric process once, so that the creator process
+  // of the tracks is compared by its sub-type instead of by its name
+  auto phot = G4ProcessTable::GetProcessTable()->FindProcess("phot", "gamma");
+  fPhotSubType = phot ? phot->GetProcessSubType() : G4int(fPhotoElectricEffect);
+
+  fNofSteps = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void XRaySteppingAction::UserSteppingAction(const G4Step* step)
 {
-// Collect energy and track length step by step
-
-  // get volume of the current step
-  auto volume = step->GetPostStepPoint()->GetTouchableHandle()->GetVolume();
-  
-  // step length
-  //G4double stepLength = 0.;
-  //if ( step->GetTrack()->GetDefinition()->GetPDGCharge() != 0. ) {
-  //  stepLength = step->GetStepLength();
-  //}
-  
-  if ( volume == fDetConstruction->GetDetectorPV() ) {
-    // Get photon energy
-    G4double Etot = step->GetTrack()->GetTotalEnergy(); 
-    // Get creator process name
-    const G4VProcess* proc = step->GetTrack()->GetCreatorProcess();
-    G4String procName;
-    if(proc != nullptr)
-      procName = proc->GetProcessName();
-    else
-      procName = "NULL";
-    // Add the energy to the appropriate histograms
-    fEventAction->AddDet(Etot);
-    if(procName == "phot")
-      fEventAction->AddDetFluo(Etot);
-  }
-  
-  
-  //if ( volume == fDetConstruction->GetGapPV() ) {
-  //  fEventAction->AddGap(edep,stepLength);
-  //}
+  ++fNofSteps;
+
+  // Nothing to score outside the detector
+  if ( step->GetPostStepPoint()->GetPhysicalVolume() != fDetectorPV ) return;
+
+  auto track = step->GetTrack();
+  auto creator = track->GetCreatorProcess();
+
+  XRayDetectorEntry entry;
+  entry.fPrimary = fEventAction->GetPrimaryIndex(track->GetTrackID());
+  entry.fEnergy = track->GetTotalEnergy();
+  entry.fWeight = track->GetWeight();
+  entry.fFromPhot = ( creator && creator->GetProcessSubType() == fPhotSubType )
+    || track->GetCreatorModelID() == XRayTargetResponseModel::GetFluoModelID();
+
+  XRayDefaultScorers::Score(fEventAction, entry);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,212 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRaySweep.cc
+/// \brief Implementation of the XRaySweep class
+
+#include "XRaySweep.hh"
+#include "XRaySweepMessenger.hh"
+#include "XRayShard.hh"
+
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommandTree.hh"
+#include "G4UIcommandStatus.hh"
+#include "G4Timer.hh"
+
+#include <fstream>
+#include <sstream>
+
+G4String XRaySweep::fLabel = "";
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySweep::XRaySweep()
+ : fMessenger(nullptr)
+{
+  fMessenger = new XRaySweepMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySweep::~XRaySweep()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySweep::AddAxis(const G4String& command, const G4String& values)
+{
+  auto tree = G4UImanager::GetUIpointer()->GetTree();
+  if ( ! tree->FindPath(command.c_str()) ) {
+    G4ExceptionDescription msg;
+    msg << "Command " << command << " not found, the axis is not added.";
+    G4Exception("XRaySweep::AddAxis()",
+      "MyCode0009", JustWarning, msg);
+    return;
+  }
+
+  // The values are separated by commas, e.g. "4 keV, 6 keV, 8 keV"
+  Axis axis;
+  axis.fCommand = command;
+  std::istringstream stream(values);
+  std::string value;
+  while ( std::getline(stream, value, ',') ) {
+    auto first = value.find_first_not_of(" \t");
+    if ( first == std::string::npos ) continue;
+    auto last = value.find_last_not_of(" \t");
+    axis.fValues.push_back(value.substr(first, last - first + 1));
+  }
+  if ( axis.fValues.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "No value given for " << command << ", the axis is not added.";
+    G4Exception("XRaySweep::AddAxis()",
+      "MyCode0009", JustWarning, msg);
+    return;
+  }
+  fAxes.push_back(axis);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySweep::Clear()
+{
+  fAxes.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySweep::BeamOn(G4int nofEvents)
+{
+  auto runManager = G4RunManager::GetRunManager();
+  if ( fAxes.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "No sweep axis is defined (/xray/sweep/axis)," << G4endl;
+    msg << "a single run is made.";
+    G4Exception("XRaySweep::BeamOn()",
+      "MyCode0009", JustWarning, msg);
+    runManager->BeamOn(nofEvents);
+    return;
+  }
+
+  G4Timer timer;
+
+  // The initialization, made once instead of at each point
+  G4double initTime = 0.;
+  auto state = G4StateManager::GetStateManager()->GetCurrentState();
+  if ( state == G4State_PreInit ) {
+    timer.Start();
+    runManager->Initialize();
+    timer.Stop();
+    initTime = timer.GetRealElapsed();
+  }
+
+  std::size_t nofPoints = 1;
+  for ( const auto& axis : fAxes ) nofPoints *= axis.fValues.size();
+
+  std::ofstream file("XRay_sweep" + XRayShard::GetSuffix() + ".csv");
+  file << "point,label";
+  for ( const auto& axis : fAxes ) file << "," << axis.fCommand;
+  file << ",setup [s],run [s]\n";
+
+  auto UImanager = G4UImanager::GetUIpointer();
+  std::vector<std::size_t> index(fAxes.size(), 0);
+  std::vector<std::size_t> previous;
+  G4double setupTime = 0.;
+  G4double firstSetupTime = 0.;
+  for ( std::size_t point=0; point<nofPoints; ++point ) {
+    // Apply the values which changed since the previous point
+    for ( std::size_t i=0; i<fAxes.size(); ++i ) {
+      if ( previous.size() && previous[i] == index[i] ) continue;
+      auto command = fAxes[i].fCommand + " " + fAxes[i].fValues[index[i]];
+      auto status = UImanager->ApplyCommand(command);
+      if ( status != fCommandSucceeded ) {
+        G4ExceptionDescription msg;
+        msg << "Command \"" << command << "\" failed (status " << status 
+            << "), the sweep is stopped.";
+        G4Exception("XRaySweep::BeamOn()",
+          "MyCode0009", JustWarning, msg);
+        fLabel = "";
+        return;
+      }
+    }
+    previous = index;
+
+    std::ostringstream label;
+    label << "_sweep" << point;
+    fLabel = label.str();
+    G4cout << G4endl << "--------------------> Sweep point " << point 
+           << " of " << nofPoints << " (" << fLabel << ") :";
+    for ( std::size_t i=0; i<fAxes.size(); ++i ) {
+      G4cout << " " << fAxes[i].fCommand << " " << fAxes[i].fValues[index[i]];
+    }
+    G4cout << G4endl;
+
+    // The run of no event closes the geometry and builds the physics 
+    // tables again, when the commands modified them
+    timer.Start();
+    runManager->BeamOn(0);
+    timer.Stop();
+    auto pointSetupTime = timer.GetRealElapsed();
+    if ( point == 0 ) firstSetupTime = pointSetupTime;
+    setupTime += pointSetupTime;
+
+    timer.Start();
+    runManager->BeamOn(nofEvents);
+    timer.Stop();
+
+    file << point << "," << fLabel;
+    for ( std::size_t i=0; i<fAxes.size(); ++i ) {
+      file << "," << fAxes[i].fValues[index[i]];
+    }
+    file << "," << pointSetupTime << "," << timer.GetRealElapsed() << "\n";
+
+    // Next point, the last axis running fastest
+    for ( auto i = fAxes.size(); i-- > 0; ) {
+      if ( ++index[i] < fAxes[i].fValues.size() ) break;
+      index[i] = 0;
+    }
+  }
+  fLabel = "";
+
+  // One process per point would make the initialization and the setup 
+  // of a first run at each point
+  auto separateTime = nofPoints*(initTime + firstSetupTime);
+  G4cout << G4endl 
+         << "--------------------> Sweep of " << nofPoints << " points" << G4endl
+         << " Initialization         : " << initTime << " s";
+  if ( state != G4State_PreInit ) G4cout << " (made before the sweep)";
+  G4cout << G4endl
+         << " Setup of the points    : " << setupTime << " s (first point " 
+         << firstSetupTime << " s)" << G4endl
+         << " Initialization saved   : " << separateTime - initTime - setupTime 
+         << " s against one process per point" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRaySweepMessenger.cc
+/// \brief Implementation of the XRaySweepMessenger class
+
+#include "XRaySweepMessenger.hh"
+#include "XRaySweep.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySweepMessenger::XRaySweepMessenger(XRaySweep* sweep)
+ : G4UImessenger(),
+   fSweep(sweep)
+{
+  fSweepDir = new G4UIdirectory("/xray/sweep/");
+  fSweepDir->SetGuidance("Parameter sweep in a single process");
+
+  fAxisCmd = new G4UIcommand("/xray/sweep/axis",this);
+  fAxisCmd->SetGuidance("Add an axis to the sweep: a command and its values,");
+  fAxisCmd->SetGuidance("separated by commas, e.g.");
+  fAxisCmd->SetGuidance("  /xray/sweep/axis /xray/det/targetThickness 1 um, 2 um, 5 um");
+  auto commandPrm = new G4UIparameter("command",'s',false);
+  fAxisCmd->SetParameter(commandPrm);
+  auto valuesPrm = new G4UIparameter("values",'s',false);
+  fAxisCmd->SetParameter(valuesPrm);
+  fAxisCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fAxisCmd->SetToBeBroadcasted(false);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/xray/sweep/clear",this);
+  fClearCmd->SetGuidance("Remove all the axes of the sweep.");
+  fClearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/xray/sweep/beamOn",this);
+  fBeamOnCmd->SetGuidance("Run the given number of events at each point of the grid");
+  fBeamOnCmd->SetGuidance("of the axes, initializing the run manager if needed.");
+  fBeamOnCmd->SetParameterName("nofEvents",false);
+  fBeamOnCmd->SetRange("nofEvents>=0");
+  fBeamOnCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRaySweepMessenger::~XRaySweepMessenger()
+{
+  delete fAxisCmd;
+  delete fClearCmd;
+  delete fBeamOnCmd;
+  delete fSweepDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRaySweepMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fAxisCmd ) {
+    // the values are the rest of the line after the command
+    auto space = newValue.find(' ');
+    G4String axisCommand = newValue.substr(0, space);
+    G4String values 
+      = ( space == std::string::npos ) ? "" : newValue.substr(space + 1);
+    fSweep->AddAxis(axisCommand, values);
+  }
+
+  if ( command == fClearCmd ) 
+   { fSweep->Clear(); }
+
+  if ( command == fBeamOnCmd ) 
+   { fSweep->BeamOn(fBeamOnCmd->GetNewIntValue(newValue)); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,139 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayTally.cc
+/// \brief Implementation of the XRayTally class
+
+#include "XRayTally.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTally::XRayTally(const G4String& name, G4int nofBins, 
+                     G4double min, G4double max, G4int nofBatches)
+ : G4VAccumulable(name),
+   fNofBins(nofBins),
+   fMin(min),
+   fMax(max),
+   fInvBinWidth(nofBins/(max - min)),
+   fNofBatches(std::max(nofBatches, 2)),
+   fSums(nofBins*fNofBatches, 0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTally::~XRayTally()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTally::Merge(const G4VAccumulable& other)
+{
+  const auto& otherTally = static_cast<const XRayTally&>(other);
+  for ( std::size_t i=0; i<fSums.size(); ++i ) {
+    fSums[i] += otherTally.fSums[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTally::Reset()
+{
+  std::fill(fSums.begin(), fSums.end(), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTally::CopyTo(G4double* data) const
+{
+  std::copy(fSums.begin(), fSums.end(), data);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTally::Add(const G4double* data)
+{
+  for ( auto& sum : fSums ) sum += *data++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTally::Fill(G4int eventID, G4double value, G4double weight)
+{
+  if ( value < fMin || value >= fMax ) return;
+
+  auto bin = G4int((value - fMin)*fInvBinWidth);
+  if ( bin >= fNofBins ) bin = fNofBins - 1;
+  auto batch = eventID % fNofBatches;
+  fSums[batch*fNofBins + bin] += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTally::ComputeStatistics(G4int bin, G4int nofEvents,
+                                  G4double& mean, G4double& relError) const
+{
+  mean = 0.;
+  relError = 0.;
+  if ( nofEvents <= 0 ) return;
+
+  // Batch sums; the events 0 .. nofEvents-1 are spread over the batches
+  std::vector<G4double> batchSums(fNofBatches, 0.);
+  for ( G4int batch=0; batch<fNofBatches; ++batch ) {
+    const auto sums = fSums.data() + batch*fNofBins;
+    if ( bin >= 0 ) {
+      batchSums[batch] = sums[bin];
+    } 
+    else {
+      for ( G4int i=0; i<fNofBins; ++i ) batchSums[batch] += sums[i];
+    }
+    mean += batchSums[batch];
+  }
+  mean /= nofEvents;
+
+  // Not enough events to fill every batch: no error estimate
+  if ( nofEvents < fNofBatches ) {
+    relError = ( mean != 0. ) ? 1. : 0.;
+    return;
+  }
+  if ( mean == 0. ) return;
+
+  // Variance of the mean from the dispersion of the batch means
+  G4double variance = 0.;
+  for ( G4int batch=0; batch<fNofBatches; ++batch ) {
+    G4int nofBatchEvents 
+      = nofEvents/fNofBatches + ( batch < nofEvents % fNofBatches ? 1 : 0 );
+    auto deviation = batchSums[batch]/nofBatchEvents - mean;
+    variance += deviation*deviation;
+  }
+  variance /= G4double(fNofBatches)*(fNofBatches - 1);
+
+  relError = std::sqrt(variance)/std::fabs(mean);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,410 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayTargetResponse.cc
+/// \brief Implementation of the XRayTargetResponse class
+
+#include "XRayTargetResponse.hh"
+
+#include "Randomize.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace {
+
+/// Header of the binary response file, in the native byte order; it is
+/// followed, for each incident bin, by the sum of the incident weights and
+/// the yield of the uncollided photons (doubles), the number of non-empty
+/// cells (32-bit), their indices (32-bit) and their yields (floats).
+
+struct XRayTargetResponseHeader
+{
+  char          fMagic[4];     // "XRTR"
+  std::uint32_t fVersion;      // 2
+  double        fEmin;         // incident energy range [MeV]
+  double        fEmax;
+  std::uint32_t fNofEnergies;
+  std::uint32_t fNofAngles;
+  std::uint32_t fNofRatios;
+  std::uint32_t fNofFluoEnergies;
+  std::uint32_t fNofCosines;
+  std::uint32_t fNofAzimuths;
+  char          fMaterial[32]; // target the table was built for
+  double        fThickness;    // [mm]
+};
+
+static_assert(sizeof(XRayTargetResponseHeader) == 88, "unexpected header padding");
+
+const std::uint32_t kVersion = 2;
+const G4double kFluoBinWidth = 10.*eV;
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponse::Frame::Frame(const G4ThreeVector& incidentDirection)
+ : fDirection(incidentDirection),
+   fSide(incidentDirection.z() >= 0. ? 1. : -1.),
+   fAzimuth(0.)
+{
+  // In the frame turned by pi around x on the +z side, the photon enters
+  // by the -z face and the exit side is +z
+  fAzimuth = std::atan2(fSide*fDirection.y(), fDirection.x());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::Frame::ToAngles(const G4ThreeVector& direction,
+                                         G4double& cosTheta, 
+                                         G4double& phi) const
+{
+  cosTheta = fSide*direction.z();
+  phi = std::atan2(fSide*direction.y(), direction.x()) - fAzimuth;
+  if ( phi < 0. ) phi += twopi;
+  if ( phi >= twopi ) phi -= twopi;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector XRayTargetResponse::Frame::ToDirection(G4double cosTheta,
+                                                     G4double phi) const
+{
+  auto sinTheta = std::sqrt(std::max(0., (1. - cosTheta)*(1. + cosTheta)));
+  auto azimuth = fAzimuth + phi;
+  return G4ThreeVector(sinTheta*std::cos(azimuth), 
+                       fSide*sinTheta*std::sin(azimuth),
+                       fSide*cosTheta);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponse::XRayTargetResponse(const G4String& name)
+ : G4VAccumulable(name),
+   fEmin(1.*keV),
+   fEmax(50.*keV),
+   fNofEnergies(40),
+   fNofAngles(8),
+   fNofRatios(1000),
+   fNofFluoEnergies(0),
+   fNofCosines(20),
+   fNofAzimuths(12),
+   fMaterial(""),
+   fThickness(0.)
+{
+  Book();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponse::~XRayTargetResponse()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::Merge(const G4VAccumulable& other)
+{
+  const auto& otherBins = static_cast<const XRayTargetResponse&>(other).fBins;
+  if ( otherBins.size() != fBins.size() ) return;
+
+  for ( std::size_t i=0; i<fBins.size(); ++i ) {
+    fBins[i].fIncident += otherBins[i].fIncident;
+    fBins[i].fUncollided += otherBins[i].fUncollided;
+    for ( const auto& cell : otherBins[i].fCells ) {
+      fBins[i].fCells[cell.first] += cell.second;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::Reset()
+{
+  for ( auto& bin : fBins ) {
+    bin.fIncident = 0.;
+    bin.fUncollided = 0.;
+    bin.fCells.clear();
+    bin.fIndices.clear();
+    bin.fCumulative.clear();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::SetTarget(const G4String& material, 
+                                   G4double thickness)
+{
+  fMaterial = material;
+  fThickness = thickness;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayTargetResponse::IsBuiltFor(const G4String& material,
+                                      G4double thickness) const
+{
+  return material == fMaterial 
+         && std::abs(thickness - fThickness) <= 1.e-6*fThickness;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::SetEnergyRange(G4double emin, G4double emax)
+{
+  // the table is reset at each run with the accumulables
+  if ( emin == fEmin && emax == fEmax ) return;
+  fEmin = emin;
+  fEmax = emax;
+  Book();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::Book()
+{
+  fNofFluoEnergies = G4int(std::ceil(fEmax/kFluoBinWidth));
+  fBins.assign(fNofEnergies*fNofAngles, Bin());
+  Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int XRayTargetResponse::GetNofOutgoingEnergies() const
+{
+  // the scattered ratios, the elastic bin, then the fluorescence energies
+  return fNofRatios + 1 + fNofFluoEnergies;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int XRayTargetResponse::FindBin(G4double energy, G4double cosTheta) const
+{
+  if ( energy < fEmin || energy >= fEmax || cosTheta <= 0. ) return -1;
+
+  auto i = G4int(fNofEnergies*std::log(energy/fEmin)/std::log(fEmax/fEmin));
+  auto j = G4int(cosTheta*fNofAngles);
+  return std::min(i, fNofEnergies - 1)*fNofAngles 
+         + std::min(j, fNofAngles - 1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::AddIncident(G4int bin, G4double weight)
+{
+  fBins[bin].fIncident += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::AddUncollided(G4int bin, G4double weight)
+{
+  fBins[bin].fUncollided += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponse::AddOutgoing(G4int bin, G4double incidentEnergy,
+                                     G4double energy, G4double cosTheta, 
+                                     G4double phi, G4bool fluo,
+                                     G4double weight)
+{
+  G4int e;
+  if ( fluo ) {
+    e = fNofRatios + 1 
+        + std::min(G4int(energy/kFluoBinWidth), fNofFluoEnergies - 1);
+  }
+  else if ( energy >= incidentEnergy ) {
+    e = fNofRatios;
+  }
+  else {
+    e = std::min(G4int(energy/incidentEnergy*fNofRatios), fNofRatios - 1);
+  }
+  auto c = std::min(G4int(0.5*(cosTheta + 1.)*fNofCosines), fNofCosines - 1);
+  auto p = std::min(G4int(phi/twopi*fNofAzimuths), fNofAzimuths - 1);
+
+  auto cell = (std::uint32_t(e)*fNofCosines + c)*fNofAzimuths + p;
+  fBins[bin].fCells[cell] += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayTargetResponse::GetNofIncident() const
+{
+  G4double nofIncident = 0.;
+  for ( const auto& bin : fBins ) nofIncident += bin.fIncident;
+  return nofIncident;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayTargetResponse::Write(const G4String& fileName) const
+{
+  std::ofstream file(fileName, std::ios::binary);
+
+  XRayTargetResponseHeader header = {};
+  std::copy_n("XRTR", 4, header.fMagic);
+  header.fVersion = kVersion;
+  header.fEmin = fEmin;
+  header.fEmax = fEmax;
+  header.fNofEnergies = fNofEnergies;
+  header.fNofAngles = fNofAngles;
+  header.fNofRatios = fNofRatios;
+  header.fNofFluoEnergies = fNofFluoEnergies;
+  header.fNofCosines = fNofCosines;
+  header.fNofAzimuths = fNofAzimuths;
+  fMaterial.copy(header.fMaterial, sizeof(header.fMaterial) - 1);
+  header.fThickness = fThickness/mm;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // the yields per incident photon of the non-empty cells
+  std::vector<std::uint32_t> indices;
+  std::vector<float> yields;
+  for ( const auto& bin : fBins ) {
+    indices.clear();
+    yields.clear();
+    G4double uncollided = 0.;
+    if ( bin.fIncident > 0. ) {
+      uncollided = bin.fUncollided/bin.fIncident;
+      for ( const auto& cell : bin.fCells ) {
+        indices.push_back(cell.first);
+        yields.push_back(float(cell.second/bin.fIncident));
+      }
+    }
+    std::uint32_t nofCells = indices.size();
+    file.write(reinterpret_cast<const char*>(&bin.fIncident), sizeof(G4double));
+    file.write(reinterpret_cast<const char*>(&uncollided), sizeof(G4double));
+    file.write(reinterpret_cast<const char*>(&nofCells), sizeof(nofCells));
+    file.write(reinterpret_cast<const char*>(indices.data()), 
+               nofCells*sizeof(std::uint32_t));
+    file.write(reinterpret_cast<const char*>(yields.data()), 
+               nofCells*sizeof(float));
+  }
+
+  return file.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayTargetResponse::Read(const G4String& fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+
+  XRayTargetResponseHeader header;
+  if ( ! file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+       ! std::equal(header.fMagic, header.fMagic + 4, "XRTR") ||
+       header.fVersion != kVersion ) return false;
+
+  fEmin = header.fEmin;
+  fEmax = header.fEmax;
+  fNofEnergies = header.fNofEnergies;
+  fNofAngles = header.fNofAngles;
+  fNofRatios = header.fNofRatios;
+  fNofFluoEnergies = header.fNofFluoEnergies;
+  fNofCosines = header.fNofCosines;
+  fNofAzimuths = header.fNofAzimuths;
+  header.fMaterial[sizeof(header.fMaterial) - 1] = 0;
+  fMaterial = header.fMaterial;
+  fThickness = header.fThickness*mm;
+  fBins.assign(fNofEnergies*fNofAngles, Bin());
+
+  auto nofCellsMax 
+    = std::uint64_t(GetNofOutgoingEnergies())*fNofCosines*fNofAzimuths;
+  std::vector<float> yields;
+  for ( auto& bin : fBins ) {
+    G4double uncollided;
+    std::uint32_t nofCells;
+    file.read(reinterpret_cast<char*>(&bin.fIncident), sizeof(G4double));
+    file.read(reinterpret_cast<char*>(&uncollided), sizeof(G4double));
+    file.read(reinterpret_cast<char*>(&nofCells), sizeof(nofCells));
+    if ( ! file || nofCells > nofCellsMax ) return false;
+
+    bin.fUncollided = uncollided*bin.fIncident;
+    bin.fIndices.resize(nofCells);
+    yields.resize(nofCells);
+    file.read(reinterpret_cast<char*>(bin.fIndices.data()), 
+              nofCells*sizeof(std::uint32_t));
+    file.read(reinterpret_cast<char*>(yields.data()), nofCells*sizeof(float));
+    if ( ! file ) return false;
+
+    // cumulative yields, for the sampling of a cell by bisection
+    bin.fCumulative.resize(nofCells);
+    G4double sum = 0.;
+    for ( std::uint32_t k=0; k<nofCells; ++k ) {
+      sum += yields[k];
+      bin.fCumulative[k] = sum;
+    }
+  }
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double XRayTargetResponse::GetYield(G4int bin) const
+{
+  const auto& b = fBins[bin];
+  if ( b.fIncident <= 0. ) return 0.;
+  return b.fUncollided/b.fIncident 
+         + ( b.fCumulative.empty() ? 0. : b.fCumulative.back() );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponse::Photon 
+XRayTargetResponse::Sample(G4int bin, G4double incidentEnergy) const
+{
+  const auto& b = fBins[bin];
+  Photon photon = { true, false, incidentEnergy, 1., 0. };
+
+  auto u = G4UniformRand()*GetYield(bin) - b.fUncollided/b.fIncident;
+  if ( u < 0. || b.fCumulative.empty() ) return photon;
+
+  auto k = std::upper_bound(b.fCumulative.begin(), b.fCumulative.end(), u)
+           - b.fCumulative.begin();
+  auto cell = b.fIndices[std::min<std::size_t>(k, b.fIndices.size() - 1)];
+  G4int p = cell % fNofAzimuths;
+  G4int c = (cell/fNofAzimuths) % fNofCosines;
+  G4int e = cell/(fNofAzimuths*fNofCosines);
+
+  photon.fUncollided = false;
+  photon.fFluo = ( e > fNofRatios );
+  if ( e < fNofRatios ) {
+    photon.fEnergy = incidentEnergy*(e + G4UniformRand())/fNofRatios;
+  }
+  else if ( e > fNofRatios ) {
+    // the fluorescence lines are kept at the center of their bin
+    photon.fEnergy = (e - fNofRatios - 1 + 0.5)*kFluoBinWidth;
+  }
+  photon.fCosTheta = -1. + 2.*(c + G4UniformRand())/fNofCosines;
+  photon.fPhi = twopi*(p + G4UniformRand())/fNofAzimuths;
+  return photon;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
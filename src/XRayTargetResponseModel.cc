@@ -0,0 +1,150 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayTargetResponseModel.cc
+/// \brief Implementation of the XRayTargetResponseModel class
+
+#include "XRayTargetResponseModel.hh"
+#include "XRayTargetResponse.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Box.hh"
+#include "G4Gamma.hh"
+#include "G4DynamicParticle.hh"
+#include "G4GeometryTolerance.hh"
+#include "Randomize.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+
+namespace {
+  // distance of the outgoing photons to the foil
+  const G4double kOffset = 1.*nm;
+}
+
+G4int XRayTargetResponseModel::fFluoModelID = -1;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponseModel::XRayTargetResponseModel(
+                           const G4String& name, G4Region* envelope,
+                           const XRayTargetResponse* response)
+ : G4VFastSimulationModel(name, envelope),
+   fResponse(response),
+   fBin(-1),
+   fHalfThickness(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponseModel::~XRayTargetResponseModel()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayTargetResponseModel::IsApplicable(
+                                  const G4ParticleDefinition& particle)
+{
+  return &particle == G4Gamma::Gamma();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayTargetResponseModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  auto box = dynamic_cast<const G4Box*>(fastTrack.GetEnvelopeSolid());
+  if ( ! box ) return false;
+  fHalfThickness = box->GetZHalfLength();
+
+  // Only the photons entering the foil by one of its faces; those created
+  // within it (by charged primaries) are transported
+  auto position = fastTrack.GetPrimaryTrackLocalPosition();
+  auto direction = fastTrack.GetPrimaryTrackLocalDirection();
+  auto tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  if ( std::abs(std::abs(position.z()) - fHalfThickness) > tolerance ||
+       position.z()*direction.z() >= 0. ) return false;
+
+  XRayTargetResponse::Frame frame(direction);
+  fBin = fResponse->FindBin(fastTrack.GetPrimaryTrack()->GetKineticEnergy(),
+                            frame.GetCosTheta());
+  return fBin >= 0 && fResponse->GetYield(fBin) > 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponseModel::DoIt(const G4FastTrack& fastTrack, 
+                                   G4FastStep& fastStep)
+{
+  auto track = fastTrack.GetPrimaryTrack();
+  auto energy = track->GetKineticEnergy();
+  auto weight = track->GetWeight();
+  auto time = track->GetGlobalTime();
+  auto position = fastTrack.GetPrimaryTrackLocalPosition();
+  auto direction = fastTrack.GetPrimaryTrackLocalDirection();
+  XRayTargetResponse::Frame frame(direction);
+
+  // Number of outgoing photons, with the yield of the bin as mean
+  auto yield = fResponse->GetYield(fBin);
+  auto nofPhotons = G4int(yield);
+  if ( G4UniformRand() < yield - nofPhotons ) ++nofPhotons;
+
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+  fastStep.SetNumberOfSecondaryTracks(nofPhotons);
+
+  for ( G4int i=0; i<nofPhotons; ++i ) {
+    auto photon = fResponse->Sample(fBin, energy);
+
+    G4ThreeVector outDirection = direction;
+    G4ThreeVector outPosition;
+    G4double outTime = time;
+    if ( photon.fUncollided ) {
+      // straight through the foil
+      auto path = (2.*fHalfThickness + kOffset)/frame.GetCosTheta();
+      outPosition = position + path*direction;
+      outTime += path/c_light;
+    }
+    else {
+      // on the face of the exit side, at the entrance point
+      outDirection = frame.ToDirection(photon.fCosTheta, photon.fPhi);
+      auto exitSide = ( photon.fCosTheta > 0. ) ? 1. : -1.;
+      outPosition = position;
+      outPosition.setZ(exitSide*frame.GetSide()*(fHalfThickness + kOffset));
+    }
+
+    G4DynamicParticle particle(G4Gamma::Gamma(), outDirection, photon.fEnergy);
+    auto secondary 
+      = fastStep.CreateSecondaryTrack(particle, outPosition, outTime, true);
+    secondary->SetWeight(weight);
+    if ( photon.fFluo ) secondary->SetCreatorModelID(GetFluoModelID());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
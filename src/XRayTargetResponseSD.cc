@@ -0,0 +1,137 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file XRayTargetResponseSD.cc
+/// \brief Implementation of the XRayTargetResponseSD class
+
+#include "XRayTargetResponseSD.hh"
+#include "XRayTargetResponse.hh"
+#include "XRayEventAction.hh"
+
+#include "G4Step.hh"
+#include "G4Gamma.hh"
+#include "G4EventManager.hh"
+#include "G4AccumulableManager.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4VProcess.hh"
+#include "G4ProcessTable.hh"
+#include "G4EmProcessSubType.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponseSD::XRayTargetResponseSD(const G4String& name)
+ : G4VSensitiveDetector(name),
+   fEventAction(nullptr),
+   fResponse(nullptr),
+   fPhotSubType(-1)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTargetResponseSD::~XRayTargetResponseSD() 
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayTargetResponseSD::Initialize(G4HCofThisEvent*)
+{
+  // Resolve the photo-electric process, the event action and the table
+  // once; none of them exists when the sensitive detector is created
+  auto eventManager = G4EventManager::GetEventManager();
+  if ( fPhotSubType < 0 ) {
+    auto phot = G4ProcessTable::GetProcessTable()->FindProcess("phot", "gamma");
+    fPhotSubType = phot ? phot->GetProcessSubType() : G4int(fPhotoElectricEffect);
+    fEventAction = dynamic_cast<XRayEventAction*>(
+      eventManager->GetUserEventAction());
+    fResponse = dynamic_cast<XRayTargetResponse*>(
+      G4AccumulableManager::Instance()->GetAccumulable("TargetResponse"));
+  }
+
+  // Called before the event action, the primaries are already generated
+  fIncidents.assign(
+    XRayEventAction::CountPrimaries(eventManager->GetConstCurrentEvent()),
+    Incident{-1, 0, 0., G4ThreeVector()});
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayTargetResponseSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{  
+  auto track = step->GetTrack();
+  if ( ! fResponse || track->GetDefinition() != G4Gamma::Gamma() ) return false;
+
+  auto primary 
+    = fEventAction ? fEventAction->GetPrimaryIndex(track->GetTrackID()) : 0;
+  if ( primary >= G4int(fIncidents.size()) ) return false;
+  auto& incident = fIncidents[primary];
+
+  auto preStepPoint = step->GetPreStepPoint();
+  auto postStepPoint = step->GetPostStepPoint();
+  const auto& transform 
+    = preStepPoint->GetTouchableHandle()->GetHistory()->GetTopTransform();
+
+  // First entrance of the primary in the target
+  if ( incident.fTrackID == 0 ) {
+    if ( track->GetParentID() != 0 || 
+         preStepPoint->GetStepStatus() != fGeomBoundary ) return false;
+    incident.fTrackID = track->GetTrackID();
+    incident.fEnergy = preStepPoint->GetKineticEnergy();
+    incident.fDirection 
+      = transform.TransformAxis(preStepPoint->GetMomentumDirection());
+    XRayTargetResponse::Frame frame(incident.fDirection);
+    incident.fBin = fResponse->FindBin(incident.fEnergy, frame.GetCosTheta());
+    if ( incident.fBin >= 0 ) {
+      fResponse->AddIncident(incident.fBin, preStepPoint->GetWeight());
+    }
+  }
+
+  // Photon of the primary leaving the target
+  if ( incident.fBin < 0 || 
+       postStepPoint->GetStepStatus() != fGeomBoundary ) return false;
+
+  auto energy = postStepPoint->GetKineticEnergy();
+  auto direction 
+    = transform.TransformAxis(postStepPoint->GetMomentumDirection());
+  auto weight = postStepPoint->GetWeight();
+  if ( track->GetTrackID() == incident.fTrackID && 
+       energy == incident.fEnergy &&
+       (direction - incident.fDirection).mag2() < 1.e-12 ) {
+    fResponse->AddUncollided(incident.fBin, weight);
+    return true;
+  }
+
+  auto creator = track->GetCreatorProcess();
+  auto fluo = ( creator && creator->GetProcessSubType() == fPhotSubType );
+  G4double cosTheta, phi;
+  XRayTargetResponse::Frame(incident.fDirection).ToAngles(direction, cosTheta, phi);
+  fResponse->AddOutgoing(incident.fBin, incident.fEnergy, energy, 
+                         cosTheta, phi, fluo, weight);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
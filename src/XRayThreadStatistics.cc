@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayThreadStatistics.cc
+/// \brief Implementation of the XRayThreadStatistics class
+
+#include "XRayThreadStatistics.hh"
+
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayThreadStatistics::XRayThreadStatistics(const G4String& name)
+ : G4VAccumulable(name)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayThreadStatistics::~XRayThreadStatistics()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayThreadStatistics::Merge(const G4VAccumulable& other)
+{
+  const auto& otherEntries 
+    = static_cast<const XRayThreadStatistics&>(other).fEntries;
+  if ( fEntries.size() < otherEntries.size() ) {
+    fEntries.resize(otherEntries.size(), Entry{0, 0., -1});
+  }
+  for ( std::size_t i=0; i<otherEntries.size(); ++i ) {
+    if ( otherEntries[i].fRealTime <= 0. ) continue;
+    fEntries[i].fNofEvents += otherEntries[i].fNofEvents;
+    fEntries[i].fRealTime += otherEntries[i].fRealTime;
+    fEntries[i].fCpu = otherEntries[i].fCpu;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayThreadStatistics::Reset()
+{
+  fEntries.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayThreadStatistics::Fill(G4int thread, G4long nofEvents,
+                                G4double realTime, G4int cpu)
+{
+  if ( thread < 0 ) thread = 0;
+  if ( G4int(fEntries.size()) <= thread ) {
+    fEntries.resize(thread + 1, Entry{0, 0., -1});
+  }
+  fEntries[thread].fNofEvents += nofEvents;
+  fEntries[thread].fRealTime += realTime;
+  fEntries[thread].fCpu = cpu;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayThreadStatistics::Print() const
+{
+  G4long nofEvents = 0;
+  G4double realTime = 0.;
+  for ( const auto& entry : fEntries ) {
+    nofEvents += entry.fNofEvents;
+    realTime += entry.fRealTime;
+  }
+  if ( nofEvents == 0 || realTime <= 0. ) return;
+  auto meanThroughput = nofEvents/realTime;
+
+  G4cout << G4endl << " ----> throughput per thread " << G4endl << G4endl;
+  G4cout << "  thread   cpu      events    events/s  relative" << G4endl;
+  for ( std::size_t i=0; i<fEntries.size(); ++i ) {
+    const auto& entry = fEntries[i];
+    if ( entry.fRealTime <= 0. ) continue;
+    auto throughput = entry.fNofEvents/entry.fRealTime;
+    G4cout << std::setw(8) << i << std::setw(6) << entry.fCpu
+           << std::setw(12) << entry.fNofEvents
+           << std::setw(12) << std::setprecision(4) << throughput
+           << std::setw(10) << std::setprecision(3) 
+           << throughput/meanThroughput
+           << ( throughput < 0.8*meanThroughput ? "  <- straggler" : "" )
+           << G4endl;
+  }
+  G4cout << std::setprecision(6);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
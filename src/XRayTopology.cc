@@ -0,0 +1,200 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayTopology.cc
+/// \brief Implementation of the XRayTopology class
+
+#include "XRayTopology.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+  const G4String kCpuDir = "/sys/devices/system/cpu/";
+  const G4String kNodeDir = "/sys/devices/system/node/";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTopology::XRayTopology()
+ : fNofCores(0),
+   fNofNodes(0)
+{
+  // NUMA node of each logical CPU
+  std::map<G4int, G4int> nodes;
+  for ( auto node : ReadList(kNodeDir + "online") ) {
+    std::ostringstream fileName;
+    fileName << kNodeDir << "node" << node << "/cpulist";
+    for ( auto cpu : ReadList(fileName.str()) ) nodes[cpu] = node;
+  }
+
+  for ( auto cpu : ReadList(kCpuDir + "online") ) {
+    std::ostringstream dir;
+    dir << kCpuDir << "cpu" << cpu << "/topology/";
+    Cpu entry;
+    entry.fCpu = cpu;
+    entry.fPackage = ReadValue(dir.str() + "physical_package_id", 0);
+    entry.fCore = ReadValue(dir.str() + "core_id", cpu);
+    // without NUMA information, a package is a node
+    auto node = nodes.find(cpu);
+    entry.fNode = ( node != nodes.end() ) ? node->second : entry.fPackage;
+    entry.fSibling = 0;
+    fCpus.push_back(entry);
+  }
+
+  // Rank of the hyperthreads of each physical core, by CPU number
+  std::map<std::pair<G4int, G4int>, G4int> siblings;
+  std::set<G4int> nodeSet;
+  for ( auto& cpu : fCpus ) {
+    cpu.fSibling = siblings[std::make_pair(cpu.fPackage, cpu.fCore)]++;
+    nodeSet.insert(cpu.fNode);
+  }
+  fNofCores = siblings.size();
+  fNofNodes = nodeSet.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayTopology::~XRayTopology()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4int> XRayTopology::GetPlacement(const G4String& policy,
+                                              G4int nofThreads) const
+{
+  std::vector<G4int> placement;
+  if ( fCpus.empty() || nofThreads <= 0 ) return placement;
+
+  // Rank of each core in its node, for the scatter policy
+  std::map<std::tuple<G4int, G4int, G4int>, G4int> coreRanks;
+  std::map<G4int, G4int> nofNodeCores;
+  for ( const auto& cpu : fCpus ) {
+    auto key = std::make_tuple(cpu.fNode, cpu.fPackage, cpu.fCore);
+    if ( coreRanks.count(key) == 0 ) coreRanks[key] = nofNodeCores[cpu.fNode]++;
+  }
+
+  auto cpus = fCpus;
+  auto scatter = ( policy == "scatter" );
+  std::sort(cpus.begin(), cpus.end(), 
+    [&](const Cpu& a, const Cpu& b) {
+      auto rankA = coreRanks[std::make_tuple(a.fNode, a.fPackage, a.fCore)];
+      auto rankB = coreRanks[std::make_tuple(b.fNode, b.fPackage, b.fCore)];
+      if ( scatter ) {
+        return std::make_tuple(a.fSibling, rankA, a.fNode, a.fCpu)
+             < std::make_tuple(b.fSibling, rankB, b.fNode, b.fCpu);
+      }
+      return std::make_tuple(a.fSibling, a.fNode, rankA, a.fCpu)
+           < std::make_tuple(b.fSibling, b.fNode, rankB, b.fCpu);
+    });
+
+  for ( G4int i=0; i<nofThreads; ++i ) {
+    placement.push_back(cpus[i % cpus.size()].fCpu);
+  }
+  return placement;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int XRayTopology::GetNode(G4int cpu) const
+{
+  for ( const auto& entry : fCpus ) {
+    if ( entry.fCpu == cpu ) return entry.fNode;
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool XRayTopology::PinCurrentThread(G4int cpu)
+{
+#ifdef __linux__
+  if ( cpu < 0 || cpu >= CPU_SETSIZE ) return false;
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int XRayTopology::GetCurrentCpu()
+{
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4int> XRayTopology::ReadList(const G4String& fileName)
+{
+  // sysfs list format: "0-3,8,10-11"
+  std::vector<G4int> values;
+  std::ifstream file(fileName);
+  std::string list;
+  if ( ! ( file >> list ) ) return values;
+
+  std::istringstream ranges(list);
+  std::string range;
+  while ( std::getline(ranges, range, ',') ) {
+    auto dash = range.find('-');
+    auto first = std::atoi(range.substr(0, dash).c_str());
+    auto last = first;
+    if ( dash != std::string::npos ) last = std::atoi(range.substr(dash + 1).c_str());
+    for ( auto value = first; value <= last; ++value ) values.push_back(value);
+  }
+  return values;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int XRayTopology::ReadValue(const G4String& fileName, G4int defaultValue)
+{
+  std::ifstream file(fileName);
+  G4int value;
+  if ( file >> value ) return value;
+  return defaultValue;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file XRayWorkerInitialization.cc
+/// \brief Implementation of the XRayWorkerInitialization class
+
+#include "XRayWorkerInitialization.hh"
+#include "XRayTopology.hh"
+
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+
+namespace {
+  G4Mutex printMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayWorkerInitialization::XRayWorkerInitialization(
+                            const std::vector<G4int>& placement,
+                            const std::vector<G4int>& nodes)
+ : G4UserWorkerInitialization(),
+   fPlacement(placement),
+   fNodes(nodes)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+XRayWorkerInitialization::~XRayWorkerInitialization()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void XRayWorkerInitialization::WorkerInitialize() const
+{
+  if ( fPlacement.empty() ) return;
+
+  auto thread = std::max(0, G4Threading::G4GetThreadId());
+  auto index = thread % fPlacement.size();
+  auto cpu = fPlacement[index];
+  auto pinned = XRayTopology::PinCurrentThread(cpu);
+
+  G4AutoLock lock(&printMutex);
+  if ( pinned ) {
+    G4cout << "Worker " << thread << " pinned to CPU " << cpu 
+           << " (NUMA node " << fNodes[index] << ")" << G4endl;
+  }
+  else {
+    G4ExceptionDescription msg;
+    msg << "The worker " << thread << " could not be pinned to the CPU " 
+        << cpu << ".";
+    G4Exception("XRayWorkerInitialization::WorkerInitialize()",
+      "MyCode0006", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,317 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file xrayFold.cc
+/// \brief Folding of source spectra with the XRay detector response matrix
+//
+// Usage: xrayFold [-m matrix] response.xrrm spectrum ...
+//
+// The response matrix file (XRayResponseFormat.hh), built by exampleXRay
+// with /xray/matrix/beamOn, holds for each tally the mean per primary of
+// its detector bins at each incident energy of a grid. Each source
+// spectrum is read in the formats of /xray/gun/spectrumFile 
+// (XRaySpectrumFormat.hh, energies in keV), a malformed file being
+// refused, and spread on the grid with the weights of the linear interpolation
+// between its rows, normalised to the whole spectrum: the intensity out 
+// of the grid is reported, and lost.
+//
+// The folded spectrum of each matrix (or only of the one named with -m)
+// is then the product of the weights with the matrix, made row by row as
+// unit-stride multiply-adds over the detector bins, which the compiler
+// vectorizes; the rows of zero weight are skipped. The relative errors
+// of the rows, from independent runs, are summed in quadrature.
+//
+// The folded spectra, per source photon, are written in 
+// <spectrum>_folded.csv, <spectrum> being the spectrum file name without
+// its extension.
+
+#include "XRayResponseFormat.hh"
+#include "XRaySpectrumFormat.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Matrix
+{
+  std::string fName;
+  std::vector<double> fMeans;     // [energy*nofBins + bin]
+  std::vector<double> fVariances; // absolute, (mean*relError)^2
+};
+
+struct Response
+{
+  XRayResponseHeader  fHeader;
+  std::vector<double> fEnergies;  // [keV]
+  std::vector<Matrix> fMatrices;
+};
+
+using Bin = XRaySpectrumBin;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadResponse(const std::string& fileName, Response& response)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  auto& header = response.fHeader;
+  file.read(reinterpret_cast<char*>(&header), sizeof(XRayResponseHeader));
+  if ( ! file || std::memcmp(header.fMagic, "XRRM", 4) != 0 
+       || header.fVersion != kXRayResponseVersion 
+       || header.fNofEnergies == 0 || header.fNofBins == 0 ) return false;
+
+  response.fMatrices.resize(header.fNofMatrices);
+  for ( auto& matrix : response.fMatrices ) {
+    char name[kXRayResponseNameLength];
+    file.read(name, kXRayResponseNameLength);
+    name[kXRayResponseNameLength - 1] = 0;
+    matrix.fName = name;
+  }
+
+  response.fEnergies.resize(header.fNofEnergies);
+  file.read(reinterpret_cast<char*>(response.fEnergies.data()), 
+            header.fNofEnergies*sizeof(double));
+  if ( ! std::is_sorted(response.fEnergies.begin(), response.fEnergies.end()) )
+    return false;
+
+  const std::size_t size = std::size_t(header.fNofEnergies)*header.fNofBins;
+  std::vector<double> relErrors(size);
+  for ( auto& matrix : response.fMatrices ) {
+    matrix.fMeans.resize(size);
+    file.read(reinterpret_cast<char*>(matrix.fMeans.data()), size*sizeof(double));
+    file.read(reinterpret_cast<char*>(relErrors.data()), size*sizeof(double));
+    matrix.fVariances.resize(size);
+    for ( std::size_t k=0; k<size; ++k ) {
+      auto error = matrix.fMeans[k]*relErrors[k];
+      matrix.fVariances[k] = error*error;
+    }
+  }
+  return bool(file);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Weights of the grid energies, the response at an energy being the
+/// linear interpolation of the rows of its two neighbours; returns the
+/// fraction of the intensity out of the grid.
+
+double ComputeWeights(const std::vector<double>& grid, 
+                      const std::vector<Bin>& bins, 
+                      std::vector<double>& weights)
+{
+  weights.assign(grid.size(), 0.);
+  double total = 0.;
+  double outside = 0.;
+  const auto first = grid.front();
+  const auto last = grid.back();
+
+  for ( const auto& bin : bins ) {
+    if ( bin.fIntensity <= 0. ) continue;
+    total += bin.fIntensity;
+
+    // Single energy grid: its row for the energies it covers
+    if ( grid.size() == 1 ) {
+      if ( bin.fLow <= first && first <= bin.fHigh ) weights[0] += bin.fIntensity;
+      else outside += bin.fIntensity;
+      continue;
+    }
+
+    // Line: split between the two neighbours
+    if ( bin.fHigh <= bin.fLow ) {
+      if ( bin.fLow < first || bin.fLow > last ) {
+        outside += bin.fIntensity;
+        continue;
+      }
+      auto k = std::upper_bound(grid.begin(), grid.end(), bin.fLow) 
+               - grid.begin() - 1;
+      k = std::min<std::ptrdiff_t>(k, grid.size() - 2);
+      auto t = (bin.fLow - grid[k])/(grid[k+1] - grid[k]);
+      weights[k] += (1. - t)*bin.fIntensity;
+      weights[k+1] += t*bin.fIntensity;
+      continue;
+    }
+
+    // Uniform bin: integral of the interpolation over each grid interval
+    auto density = bin.fIntensity/(bin.fHigh - bin.fLow);
+    auto inside = 0.;
+    for ( std::size_t k=0; k+1<grid.size(); ++k ) {
+      auto low = std::max(bin.fLow, grid[k]);
+      auto high = std::min(bin.fHigh, grid[k+1]);
+      if ( high <= low ) continue;
+      auto length = high - low;
+      auto middle = 0.5*(low + high);
+      auto width = grid[k+1] - grid[k];
+      weights[k] += density*length*(grid[k+1] - middle)/width;
+      weights[k+1] += density*length*(middle - grid[k])/width;
+      inside += density*length;
+    }
+    outside += std::max(0., bin.fIntensity - inside);
+  }
+
+  if ( total <= 0. ) return 1.;
+  for ( auto& weight : weights ) weight /= total;
+  return outside/total;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// y += a*x over n values, unit stride and no aliasing: vectorized
+
+inline void MultiplyAdd(std::size_t n, double a, 
+                        const double* __restrict x, double* __restrict y)
+{
+  for ( std::size_t j=0; j<n; ++j ) y[j] += a*x[j];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Fold(const Matrix& matrix, std::size_t nofBins, 
+          const std::vector<double>& weights,
+          std::vector<double>& means, std::vector<double>& variances)
+{
+  means.assign(nofBins, 0.);
+  variances.assign(nofBins, 0.);
+  for ( std::size_t i=0; i<weights.size(); ++i ) {
+    auto weight = weights[i];
+    if ( weight == 0. ) continue;
+    MultiplyAdd(nofBins, weight, &matrix.fMeans[i*nofBins], means.data());
+    MultiplyAdd(nofBins, weight*weight, &matrix.fVariances[i*nofBins], 
+                variances.data());
+  }
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  std::string matrixName;
+  std::string responseName;
+  std::vector<std::string> spectrumNames;
+  for ( int i=1; i<argc; ++i ) {
+    std::string argument = argv[i];
+    if ( argument == "-m" && i + 1 < argc ) matrixName = argv[++i];
+    else if ( responseName.empty() ) responseName = argument;
+    else spectrumNames.push_back(argument);
+  }
+  if ( responseName.empty() || spectrumNames.empty() ) {
+    std::cerr << "Usage: xrayFold [-m matrix] response.xrrm spectrum ..." 
+              << std::endl;
+    return 1;
+  }
+
+  Response response;
+  if ( ! ReadResponse(responseName, response) ) {
+    std::cerr << "Cannot read a response matrix from " << responseName 
+              << std::endl;
+    return 1;
+  }
+  const auto& header = response.fHeader;
+  const std::size_t nofBins = header.fNofBins;
+
+  std::vector<const Matrix*> matrices;
+  for ( const auto& matrix : response.fMatrices ) {
+    if ( matrixName.empty() || matrix.fName == matrixName ) {
+      matrices.push_back(&matrix);
+    }
+  }
+  if ( matrices.empty() ) {
+    std::cerr << "No matrix " << matrixName << " in " << responseName 
+              << std::endl;
+    return 1;
+  }
+  std::cout << responseName << " : " << header.fNofEnergies 
+            << " energies from " << response.fEnergies.front() << " to "
+            << response.fEnergies.back() << " keV x " << nofBins 
+            << " bins, " << header.fNofEvents << " events each" << std::endl;
+
+  int status = 0;
+  std::vector<Bin> bins;
+  std::vector<double> weights;
+  std::vector<std::vector<double>> means(matrices.size());
+  std::vector<std::vector<double>> variances(matrices.size());
+  for ( const auto& spectrumName : spectrumNames ) {
+    std::string error;
+    if ( ! ReadXRaySpectrum(spectrumName, bins, error) ) {
+      std::cerr << "Cannot read a spectrum from " << spectrumName << ": "
+                << error << std::endl;
+      status = 1;
+      continue;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto outside = ComputeWeights(response.fEnergies, bins, weights);
+    for ( std::size_t m=0; m<matrices.size(); ++m ) {
+      Fold(*matrices[m], nofBins, weights, means[m], variances[m]);
+    }
+    std::chrono::duration<double, std::milli> elapsed 
+      = std::chrono::steady_clock::now() - start;
+
+    auto dot = spectrumName.find_last_of('.');
+    auto slash = spectrumName.find_last_of('/');
+    if ( dot != std::string::npos && slash != std::string::npos && dot < slash ) 
+      dot = std::string::npos;
+    auto outputName = spectrumName.substr(0, dot) + "_folded.csv";
+    std::ofstream output(outputName);
+    output << "bin,low [keV],high [keV]";
+    for ( auto matrix : matrices ) {
+      output << "," << matrix->fName << "," << matrix->fName << " relError";
+    }
+    output << "\n";
+    auto binWidth = (header.fMax - header.fMin)/nofBins;
+    for ( std::size_t j=0; j<nofBins; ++j ) {
+      output << j << "," << header.fMin + j*binWidth << "," 
+             << header.fMin + (j + 1)*binWidth;
+      for ( std::size_t m=0; m<matrices.size(); ++m ) {
+        auto mean = means[m][j];
+        output << "," << mean << "," 
+               << ( mean > 0. ? std::sqrt(variances[m][j])/mean : 0. );
+      }
+      output << "\n";
+    }
+
+    std::cout << spectrumName << " folded in " << elapsed.count() << " ms :";
+    for ( std::size_t m=0; m<matrices.size(); ++m ) {
+      double sum = 0.;
+      for ( auto mean : means[m] ) sum += mean;
+      std::cout << " " << matrices[m]->fName << " " << sum;
+    }
+    std::cout << " per source photon -> " << outputName << std::endl;
+    if ( outside > 0. ) {
+      std::cout << "  " << 100.*outside << " % of the intensity is out of the"
+                << " grid and not folded" << std::endl;
+    }
+  }
+
+  return status;
+}
@@ -0,0 +1,380 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file xrayMerge.cc
+/// \brief Merger of the shard files of a sharded XRay job
+//
+// Usage: xrayMerge [-j nThreads] [-l listFile] [-f] output shard.xrsh ...
+//
+// The shard files (XRayShardFormat.hh), given on the command line and/or
+// listed one per line in listFile, are read and summed in parallel by 
+// nThreads threads (the number of cores by default). The merge checks 
+// that all the files belong to the same job (configuration hash, number 
+// of shards, layout of the values), and that each shard is present once;
+// a duplicated or missing shard is an error, unless -f is given.
+//
+// The merge writes output.xrsh, the merged shard file, output_histograms.csv
+// with the bins of the histograms, and output_tallies.csv with the mean per
+// primary of each tally bin and its batch-means relative error.
+
+#include "XRayShardFormat.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Shard
+{
+  std::string fFileName;
+  XRayShardHeader fHeader;
+  std::vector<std::string> fNames;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadHeader(std::ifstream& file, Shard& shard)
+{
+  file.read(reinterpret_cast<char*>(&shard.fHeader), sizeof(XRayShardHeader));
+  if ( ! file || std::memcmp(shard.fHeader.fMagic, "XRSH", 4) != 0 
+       || shard.fHeader.fVersion != kXRayShardVersion ) return false;
+
+  shard.fNames.clear();
+  for ( std::uint32_t i=0; i<shard.fHeader.fNofHistograms; ++i ) {
+    char name[kXRayShardNameLength];
+    file.read(name, kXRayShardNameLength);
+    name[kXRayShardNameLength - 1] = 0;
+    shard.fNames.push_back(name);
+  }
+  return bool(file);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool SameJob(const XRayShardHeader& a, const XRayShardHeader& b)
+{
+  return a.fConfigHash == b.fConfigHash && a.fNofShards == b.fNofShards
+      && a.fNofHistograms == b.fNofHistograms 
+      && a.fNofHistogramBins == b.fNofHistogramBins
+      && a.fNofTallies == b.fNofTallies && a.fNofTallyBins == b.fNofTallyBins
+      && a.fNofBatches == b.fNofBatches && a.fNofValues == b.fNofValues
+      && a.fMin == b.fMin && a.fMax == b.fMax;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Mean per event and relative error of a tally bin (-1 for the whole
+// tally), as XRayTally::ComputeStatistics()
+void ComputeStatistics(const double* sums, const XRayShardHeader& header,
+                       long bin, double& mean, double& relError)
+{
+  const long nofBins = header.fNofTallyBins;
+  const long nofBatches = header.fNofBatches;
+  const long nofEvents = header.fNofEvents;
+  mean = 0.;
+  relError = 0.;
+  if ( nofEvents <= 0 ) return;
+
+  std::vector<double> batchSums(nofBatches, 0.);
+  for ( long batch=0; batch<nofBatches; ++batch ) {
+    const auto batchBins = sums + batch*nofBins;
+    if ( bin >= 0 ) batchSums[batch] = batchBins[bin];
+    else for ( long i=0; i<nofBins; ++i ) batchSums[batch] += batchBins[i];
+    mean += batchSums[batch];
+  }
+  mean /= nofEvents;
+
+  if ( nofEvents < nofBatches ) {
+    relError = ( mean != 0. ) ? 1. : 0.;
+    return;
+  }
+  if ( mean == 0. ) return;
+
+  double variance = 0.;
+  for ( long batch=0; batch<nofBatches; ++batch ) {
+    long nofBatchEvents 
+      = nofEvents/nofBatches + ( batch < nofEvents % nofBatches ? 1 : 0 );
+    auto deviation = batchSums[batch]/nofBatchEvents - mean;
+    variance += deviation*deviation;
+  }
+  variance /= double(nofBatches)*(nofBatches - 1);
+  relError = std::sqrt(variance)/std::fabs(mean);
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  unsigned nofThreads = std::max(1u, std::thread::hardware_concurrency());
+  bool force = false;
+  std::string output;
+  std::vector<std::string> fileNames;
+  for ( int i=1; i<argc; ++i ) {
+    std::string argument = argv[i];
+    if ( argument == "-j" && i + 1 < argc ) {
+      nofThreads = std::max(1, std::atoi(argv[++i]));
+    }
+    else if ( argument == "-l" && i + 1 < argc ) {
+      std::ifstream list(argv[++i]);
+      if ( ! list ) {
+        std::cerr << "Cannot open " << argv[i] << std::endl;
+        return 1;
+      }
+      std::string line;
+      while ( list >> line ) fileNames.push_back(line);
+    }
+    else if ( argument == "-f" ) force = true;
+    else if ( output.empty() ) output = argument;
+    else fileNames.push_back(argument);
+  }
+  if ( output.empty() || fileNames.empty() ) {
+    std::cerr << "Usage: xrayMerge [-j nThreads] [-l listFile] [-f]"
+              << " output shard.xrsh ..." << std::endl;
+    return 1;
+  }
+  nofThreads = std::min<unsigned>(nofThreads, fileNames.size());
+
+  // Each thread sums its files into its own values
+  std::vector<Shard> shards(fileNames.size());
+  std::vector<std::vector<double>> threadValues(nofThreads);
+  std::atomic<std::size_t> next(0);
+  std::mutex errorMutex;
+  std::vector<std::string> errors;
+
+  auto work = [&](unsigned thread) {
+    auto& values = threadValues[thread];
+    std::vector<double> buffer;
+    for ( auto i = next++; i < fileNames.size(); i = next++ ) {
+      auto& shard = shards[i];
+      shard.fFileName = fileNames[i];
+      std::ifstream file(fileNames[i], std::ios::binary);
+      std::string error;
+      if ( ! file || ! ReadHeader(file, shard) ) {
+        error = "not a shard file";
+      }
+      else {
+        buffer.resize(shard.fHeader.fNofValues);
+        file.read(reinterpret_cast<char*>(buffer.data()), 
+                  buffer.size()*sizeof(double));
+        if ( ! file ) error = "truncated";
+      }
+      if ( ! error.empty() ) {
+        shard.fHeader.fNofValues = 0;
+        std::lock_guard<std::mutex> lock(errorMutex);
+        errors.push_back(fileNames[i] + ": " + error);
+        continue;
+      }
+      if ( values.empty() ) values.assign(buffer.size(), 0.);
+      if ( values.size() != buffer.size() ) continue; // reported below
+      for ( std::size_t k=0; k<buffer.size(); ++k ) values[k] += buffer[k];
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for ( unsigned thread=0; thread<nofThreads; ++thread ) {
+    threads.emplace_back(work, thread);
+  }
+  for ( auto& thread : threads ) thread.join();
+
+  // Verification: one job, each shard once
+  const Shard* reference = nullptr;
+  for ( const auto& shard : shards ) {
+    if ( shard.fHeader.fNofValues > 0 ) { reference = &shard; break; }
+  }
+  if ( ! reference ) {
+    for ( const auto& error : errors ) std::cerr << error << std::endl;
+    std::cerr << "No shard file could be read" << std::endl;
+    return 2;
+  }
+  const auto& job = reference->fHeader;
+
+  XRayShardHeader merged = job;
+  merged.fShard = kXRayMergedShard;
+  merged.fNofEvents = 0;
+  merged.fFirstEventID = 0;
+  merged.fNofMerged = 0;
+  merged.fRealTime = 0.;
+
+  std::vector<int> counts(job.fNofShards, 0);
+  std::vector<bool> merge(shards.size(), false);
+  for ( std::size_t i=0; i<shards.size(); ++i ) {
+    const auto& shard = shards[i];
+    const auto& header = shard.fHeader;
+    if ( header.fNofValues == 0 ) continue;
+    if ( ! SameJob(header, job) || header.fShard >= job.fNofShards ) {
+      errors.push_back(shard.fFileName + ": not a shard of the job of " 
+                       + reference->fFileName);
+      continue;
+    }
+    if ( ++counts[header.fShard] > 1 ) {
+      std::ostringstream error;
+      error << shard.fFileName << ": duplicated shard " << header.fShard;
+      errors.push_back(error.str());
+      continue;
+    }
+    merge[i] = true;
+    merged.fNofEvents += header.fNofEvents;
+    merged.fRealTime += header.fRealTime;
+    ++merged.fNofMerged;
+  }
+  std::size_t nofMissing = 0;
+  for ( std::uint32_t i=0; i<job.fNofShards; ++i ) {
+    if ( counts[i] > 0 ) continue;
+    if ( ++nofMissing <= 20 ) {
+      std::ostringstream error;
+      error << "missing shard " << i;
+      errors.push_back(error.str());
+    }
+  }
+  if ( nofMissing > 20 ) {
+    std::ostringstream error;
+    error << nofMissing << " missing shards in total";
+    errors.push_back(error.str());
+  }
+
+  for ( const auto& error : errors ) std::cerr << error << std::endl;
+  if ( ! errors.empty() && ! force ) {
+    std::cerr << "The shards are not merged (use -f to merge anyway)" 
+              << std::endl;
+    return 2;
+  }
+
+  // Without errors the thread sums are those of the merged files; 
+  // otherwise (forced merge) the sums are made again with the files of
+  // the job only, a duplicated shard being counted once
+  std::vector<double> values(job.fNofValues, 0.);
+  if ( errors.empty() ) {
+    for ( const auto& partial : threadValues ) {
+      if ( partial.size() != values.size() ) continue;
+      for ( std::size_t k=0; k<values.size(); ++k ) values[k] += partial[k];
+    }
+  }
+  else {
+    std::vector<double> buffer(job.fNofValues);
+    for ( std::size_t i=0; i<shards.size(); ++i ) {
+      if ( ! merge[i] ) continue;
+      std::ifstream file(shards[i].fFileName, std::ios::binary);
+      Shard header;
+      ReadHeader(file, header);
+      file.read(reinterpret_cast<char*>(buffer.data()), 
+                buffer.size()*sizeof(double));
+      for ( std::size_t k=0; k<values.size(); ++k ) values[k] += buffer[k];
+    }
+  }
+
+  // Merged shard file
+  {
+    std::ofstream file(output + ".xrsh", std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&merged), sizeof(merged));
+    for ( const auto& name : reference->fNames ) {
+      char buffer[kXRayShardNameLength] = { 0 };
+      name.copy(buffer, kXRayShardNameLength - 1);
+      file.write(buffer, kXRayShardNameLength);
+    }
+    file.write(reinterpret_cast<const char*>(values.data()), 
+               values.size()*sizeof(double));
+    if ( ! file ) {
+      std::cerr << "Cannot write " << output << ".xrsh" << std::endl;
+      return 1;
+    }
+  }
+
+  const double nofPrimaries = values[0];
+  const double primariesPerEvent 
+    = merged.fNofEvents > 0 ? nofPrimaries/merged.fNofEvents : 1.;
+  const std::size_t histogramSize = 5*(job.fNofHistogramBins + 2);
+  const std::size_t tallySize = std::size_t(job.fNofTallyBins)*job.fNofBatches;
+  const double binWidth = (job.fMax - job.fMin)/job.fNofHistogramBins;
+  const double tallyBinWidth = (job.fMax - job.fMin)/job.fNofTallyBins;
+
+  // the counter of the runs scoring all the photons (/xray/scoring all)
+  const char* scoring = values[9] > 0. ? "all" : "first";
+
+  // Histograms: bin 0 is the underflow, bin N+1 the overflow
+  {
+    std::ofstream file(output + "_histograms.csv");
+    file << "histogram,bin,low [keV],high [keV],entries,sw,sw2,sxw,sx2w\n";
+    auto histograms = values.data() + kXRayShardNofCounters;
+    for ( std::uint32_t h=0; h<job.fNofHistograms; ++h ) {
+      const auto bins = histograms + h*histogramSize;
+      for ( std::uint32_t bin=0; bin<job.fNofHistogramBins + 2; ++bin ) {
+        file << reference->fNames[h] << "," << bin << ","
+             << job.fMin + (long(bin) - 1)*binWidth << ","
+             << job.fMin + bin*binWidth;
+        for ( int k=0; k<5; ++k ) file << "," << bins[5*bin + k];
+        file << "\n";
+      }
+    }
+  }
+
+  // Tallies, per primary
+  {
+    std::ofstream file(output + "_tallies.csv");
+    file << "# events " << merged.fNofEvents << ", primaries " << nofPrimaries
+         << ", shards " << merged.fNofMerged << " of " << job.fNofShards 
+         << ", scoring " << scoring << "\n";
+    file << "tally,bin,low [keV],high [keV],mean,relError\n";
+    auto tallies = values.data() + kXRayShardNofCounters 
+                 + job.fNofHistograms*histogramSize;
+    for ( std::uint32_t t=0; t<job.fNofTallies; ++t ) {
+      const auto sums = tallies + t*tallySize;
+      for ( long bin=-1; bin<long(job.fNofTallyBins); ++bin ) {
+        double mean, relError;
+        ComputeStatistics(sums, merged, bin, mean, relError);
+        auto low = job.fMin + (bin < 0 ? 0 : bin)*tallyBinWidth;
+        auto high = bin < 0 ? job.fMax : low + tallyBinWidth;
+        file << reference->fNames[t] << "," << bin << "," << low << "," 
+             << high << "," << mean/primariesPerEvent << "," << relError 
+             << "\n";
+        if ( bin < 0 ) {
+          std::cout << " " << reference->fNames[t] << " : " 
+                    << mean/primariesPerEvent << " +- " << 100.*relError 
+                    << " % per primary" << std::endl;
+        }
+      }
+    }
+  }
+
+  std::cout << merged.fNofMerged << " shards of " << job.fNofShards 
+            << " merged into " << output << " (" << merged.fNofEvents 
+            << " events, scoring " << scoring << ", configuration " 
+            << std::hex << job.fConfigHash << std::dec << ")" << std::endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,126 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file xrayPhaseSpace.cc
+/// \brief Converter of CSV phase spaces to the XRay phase-space format
+//
+// Usage: xrayPhaseSpace input.csv output.xrps
+//
+// Each CSV line holds one record: x,y,z [mm],dx,dy,dz,E [keV],weight.
+// The weight column is optional (1 by default), the directions are 
+// normalised, and lines which do not start with a number (header, 
+// comments) are skipped.
+
+#include "XRayPhaseSpaceFormat.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  if ( argc != 3 ) {
+    std::cerr << "Usage: xrayPhaseSpace input.csv output.xrps" << std::endl;
+    return 1;
+  }
+
+  std::ifstream input(argv[1]);
+  if ( ! input ) {
+    std::cerr << "Cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+  std::ofstream output(argv[2], std::ios::binary);
+  if ( ! output ) {
+    std::cerr << "Cannot create " << argv[2] << std::endl;
+    return 1;
+  }
+
+  // The number of records is written once they are all converted
+  XRayPhaseSpaceHeader header;
+  std::memcpy(header.fMagic, "XRPS", 4);
+  header.fVersion = kXRayPhaseSpaceVersion;
+  header.fNofRecords = 0;
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::string line;
+  std::size_t lineNumber = 0;
+  std::size_t nofSkipped = 0;
+  while ( std::getline(input, line) ) {
+    ++lineNumber;
+    for ( auto& character : line ) {
+      if ( character == ',' || character == ';' ) character = ' ';
+    }
+    std::istringstream stream(line);
+    double values[8] = { 0., 0., 0., 0., 0., 0., 0., 1. };
+    int nofValues = 0;
+    while ( nofValues < 8 && stream >> values[nofValues] ) ++nofValues;
+    if ( nofValues == 0 ) continue;
+    if ( nofValues < 7 ) {
+      ++nofSkipped;
+      continue;
+    }
+
+    auto norm = std::sqrt(values[3]*values[3] + values[4]*values[4] 
+                        + values[5]*values[5]);
+    if ( norm <= 0. || values[6] <= 0. ) {
+      std::cerr << "Line " << lineNumber << ": invalid record, skipped" 
+                << std::endl;
+      ++nofSkipped;
+      continue;
+    }
+
+    XRayPhaseSpaceRecord record;
+    for ( int i=0; i<3; ++i ) {
+      record.fPosition[i] = float(values[i]);
+      record.fDirection[i] = float(values[3+i]/norm);
+    }
+    record.fEnergy = float(values[6]);
+    record.fWeight = float(values[7]);
+    output.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    ++header.fNofRecords;
+  }
+
+  output.seekp(0);
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if ( ! output ) {
+    std::cerr << "Cannot write " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cout << header.fNofRecords << " records written to " << argv[2];
+  if ( nofSkipped > 0 ) std::cout << ", " << nofSkipped << " lines skipped";
+  std::cout << std::endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......